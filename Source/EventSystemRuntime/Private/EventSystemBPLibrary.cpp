@@ -4,6 +4,7 @@
 #include "Engine/UserDefinedEnum.h"
 #include "JsonUtilities/Public/JsonObjectConverter.h"
 #include "GIEventSubsystem.h"
+#include "WorldEventSubsystem.h"
 #include "Engine/GameInstance.h"
 
 
@@ -18,28 +19,78 @@ void UEventSystemBPLibrary::NotifyEventByKeyVariadic(const FString& MessageId, U
 
 }
 
+void UEventSystemBPLibrary::NotifyEventByKeyVariadicInScope(const FString& MessageId, UObject* Sender, EEventScope Scope)
+{
+
+}
+
 FEventHandle UEventSystemBPLibrary::ListenEventByKey(const FString& MessageId, UObject* Listener, FName EventName)
 {
-	UGIEventSubsystem* System = UGIEventSubsystem::Get(Listener);
-	if (System) return System->ListenEvent(MessageId, Listener, EventName);
+	return ListenEventByKeyInScope(MessageId, Listener, EventName, EEventScope::GameInstance);
+}
+
+FEventHandle UEventSystemBPLibrary::ListenEventByKeyInScope(const FString& MessageId, UObject* Listener, FName EventName, EEventScope Scope)
+{
+	FEventChannel* Channel = GetChannel(Scope, Listener);
+	if (Channel) return Channel->ListenEvent(MessageId, Listener, EventName);
 	return FEventHandle();
 }
 
 void UEventSystemBPLibrary::UnListenEvent(const UObject* WorldContext, const FEventHandle& Handle)
 {
-	UGIEventSubsystem* System = UGIEventSubsystem::Get(WorldContext);
-	if (System) System->UnListenEvent(Handle);
+	// World handles may be tracked by the spatial index of the world as well
+	if (Handle.Scope == EEventScope::World)
+	{
+		UWorldEventSubsystem* System = UWorldEventSubsystem::Get(WorldContext);
+		if (System) System->UnListenEvent(Handle);
+		return;
+	}
+
+	// Level handles live in the channel of their listener's level
+	const UObject* Context = Handle.Scope == EEventScope::Level && Handle.Listener.IsValid() ? Handle.Listener.Get() : WorldContext;
+	FEventChannel* Channel = GetChannel(Handle.Scope, Context, false);
+	if (Channel) Channel->UnListenEvent(Handle);
 }
 
 // FIX (blowpunch)
 void UEventSystemBPLibrary::UnListenEvents(UObject* Listener)
 {
-	UGIEventSubsystem* System = UGIEventSubsystem::Get(Listener);
-	if (System) 
-		System->UnListenEvents(Listener);
+	UWorldEventSubsystem* WorldSystem = UWorldEventSubsystem::Get(Listener);
+	if (WorldSystem)
+		WorldSystem->UnListenEvents(Listener);
+
+	for (EEventScope Scope : { EEventScope::GameInstance, EEventScope::Level })
+	{
+		FEventChannel* Channel = GetChannel(Scope, Listener, false);
+		if (Channel)
+			Channel->UnListenEvents(Listener);
+	}
 }
 ///
 
+FEventChannel* UEventSystemBPLibrary::GetChannel(EEventScope Scope, const UObject* Context, bool bCreate)
+{
+	if (Scope == EEventScope::GameInstance)
+	{
+		UGIEventSubsystem* System = UGIEventSubsystem::Get(Context);
+		return System ? &System->GetChannel() : nullptr;
+	}
+
+	UWorldEventSubsystem* System = UWorldEventSubsystem::Get(Context);
+	if (!System)
+	{
+		return nullptr;
+	}
+
+	if (Scope == EEventScope::World)
+	{
+		return &System->GetWorldChannel();
+	}
+
+	ULevel* Level = System->GetLevelOf(Context);
+	return bCreate ? &System->FindOrAddLevelChannel(Level) : System->FindLevelChannel(Level);
+}
+
 FString UEventSystemBPLibrary::Conv_EventHandleToString(const FEventHandle& InRot)
 {
 	return InRot.ToString();
@@ -105,11 +156,12 @@ FName UEventSystemBPLibrary::LocalName(const FName& Value)
 	return Value;
 }
 
-void UEventSystemBPLibrary::NotifyEventByKey(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames)
+void UEventSystemBPLibrary::NotifyEventByKey(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames, EEventScope Scope)
 {
-	UGIEventSubsystem* System = UGIEventSubsystem::Get(Sender);
-	if (System)
-		System->NotifyEventWithParams(EventId, Sender, Outparames);
+	// Nobody listens in a level without a channel, don't create one just to notify it
+	FEventChannel* Channel = GetChannel(Scope, Sender, false);
+	if (Channel)
+		Channel->NotifyEventWithParams(EventId, Sender, Outparames);
 }
 
 DEFINE_FUNCTION(UEventSystemBPLibrary::execNotifyEventByKeyVariadic)
@@ -127,6 +179,7 @@ DEFINE_FUNCTION(UEventSystemBPLibrary::execNotifyEventByKeyVariadic)
 		FOutputParam& OutParam = OutParms.AddDefaulted_GetRef();
 		OutParam.Property = Stack.MostRecentProperty;
 		OutParam.PropAddr = Stack.MostRecentPropertyAddress;
+		OutParam.Size = Stack.MostRecentProperty->ElementSize;
 
 	}
 	P_FINISH
@@ -135,3 +188,27 @@ DEFINE_FUNCTION(UEventSystemBPLibrary::execNotifyEventByKeyVariadic)
 	UEventSystemBPLibrary::NotifyEventByKey(MessageId, Sender, OutParms);
 	P_NATIVE_END
 }
+
+DEFINE_FUNCTION(UEventSystemBPLibrary::execNotifyEventByKeyVariadicInScope)
+{
+	P_GET_PROPERTY(FStrProperty, MessageId);
+	P_GET_OBJECT(UObject, Sender);
+	P_GET_ENUM(EEventScope, Scope);
+
+	TArray<FOutputParam, TInlineAllocator<8>> OutParms;
+	while (Stack.PeekCode() != EX_EndFunctionParms)
+	{
+		Stack.StepCompiledIn<FProperty>(nullptr);
+		check(Stack.MostRecentProperty&& Stack.MostRecentPropertyAddress);
+
+		FOutputParam& OutParam = OutParms.AddDefaulted_GetRef();
+		OutParam.Property = Stack.MostRecentProperty;
+		OutParam.PropAddr = Stack.MostRecentPropertyAddress;
+		OutParam.Size = Stack.MostRecentProperty->ElementSize;
+	}
+	P_FINISH
+
+	P_NATIVE_BEGIN
+	UEventSystemBPLibrary::NotifyEventByKey(MessageId, Sender, OutParms, Scope);
+	P_NATIVE_END
+}
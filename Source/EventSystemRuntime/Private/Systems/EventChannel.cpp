@@ -0,0 +1,751 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "Systems/EventChannel.h"
+#include "EventSystemRuntime.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/Ticker.h"
+
+FOnResolveEventParameters FEventChannel::ResolveEventParameters;
+
+static int32 EventParallelDispatchThreshold = 64;
+static FAutoConsoleVariableRef CVarEventParallelDispatchThreshold(TEXT("EventSystem.ParallelDispatchThreshold"), EventParallelDispatchThreshold, TEXT("Minimum number of AnyThread listeners of an event before they are dispatched with ParallelFor"), ECVF_Default);
+
+FEventHandle::FEventHandle(UObject* InListener, FName InEventName, FName InMsgID, EEventScope InScope)
+{
+	Listener = TWeakObjectPtr<UObject>(InListener);
+	EventName = InEventName;
+	MsgId = InMsgID;
+	Scope = InScope;
+}
+
+FEventChannel::FEventChannel(EEventScope InScope)
+	: Scope(InScope)
+	, SelfToken(MakeShared<FEventChannel*, ESPMode::ThreadSafe>(this))
+{
+}
+
+FEventChannel::~FEventChannel()
+{
+	*SelfToken = nullptr;
+	if (TrailingFlushHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TrailingFlushHandle);
+	}
+}
+
+FEventClassListeners* FEventListeners::FindClass(const UClass* Class, FName EventName)
+{
+	// A handful of classes per event, a linear scan beats hashing
+	for (FEventClassListeners& ClassListeners : Classes)
+	{
+		if (ClassListeners.EventName == EventName && ClassListeners.Class.Get() == Class)
+		{
+			return &ClassListeners;
+		}
+	}
+	return nullptr;
+}
+
+const FEventListenerSnapshotPtr& FEventListeners::GetSnapshot()
+{
+	if (!Snapshot.IsValid())
+	{
+		TSharedRef<FEventListenerSnapshot, ESPMode::ThreadSafe> NewSnapshot = MakeShared<FEventListenerSnapshot, ESPMode::ThreadSafe>();
+		NewSnapshot->Classes = Classes;
+		NewSnapshot->NativeListeners = NativeListeners;
+		NewSnapshot->bHasGameThreadListeners = Classes.Num() || NativeListeners.ContainsByPredicate([](const FEventNativeListener& Native) { return !Native.bAnyThread; });
+		Snapshot = NewSnapshot;
+	}
+	return Snapshot;
+}
+
+void FEventChannel::NotifyEventWithParams(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames)
+{
+	// An id that was never registered has no listener on any channel
+	const FEventKey Key = FEventKey::Find(EventId);
+	if (Key.IsValid())
+	{
+		NotifyEventWithParams(Key, Sender, Outparames);
+	}
+}
+
+void FEventChannel::NotifyEventWithParams(FEventKey Key, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames)
+{
+	FShard& Shard = GetShard(Key);
+
+	// Listeners may listen or unlisten while being notified, dispatch from the snapshot taken under the lock
+	FEventListenerSnapshotPtr Snapshot;
+	{
+		FScopeLock Lock(&Shard.Lock);
+		FEventListeners* ListenersPtr = Shard.ListenerMap.Find(Key);
+		if (!ListenersPtr) return;
+
+		FEventSchema& Schema = Shard.Schemas.FindChecked(Key);
+		if (!PrepareNotify(Shard, Key, *ListenersPtr, Schema, Sender, Outparames))
+		{
+			return;
+		}
+
+		Snapshot = ListenersPtr->GetSnapshot();
+
+		if (!IsInGameThread())
+		{
+			const FEventSchema::FParameterList Layout = Schema.GetPayloadLayout();
+			Lock.Unlock();
+			DispatchToNativeListeners(Snapshot->NativeListeners, Outparames, true);
+
+			if (!Snapshot->bHasGameThreadListeners)
+			{
+				return;
+			}
+
+			if (!Layout.Num() && Outparames.Num())
+			{
+				const FString& EventId = Key.GetEventId();
+				ReportMismatchOnce(EventId + TEXT("/deferred"), FString::Printf(TEXT("Dropped notify of %s from another thread: neither a listener function nor the dictionary describes its payload"), *EventId));
+				return;
+			}
+
+			// The payload lives on the caller's stack, keep a copy until the game thread got to it
+			FEventPayloadPtr Payload = MakeShared<FEventPayload, ESPMode::ThreadSafe>(Layout, Outparames);
+			AsyncTask(ENamedThreads::GameThread, [Snapshot, Payload = MoveTemp(Payload)]()
+			{
+				DispatchToListeners(Snapshot->Classes, Payload->Values);
+				DispatchToNativeListeners(Snapshot->NativeListeners, Payload->Values, false);
+			});
+			return;
+		}
+	}
+
+	bool bHasInvalidListeners = DispatchToListeners(Snapshot->Classes, Outparames);
+	bHasInvalidListeners |= DispatchToNativeListeners(Snapshot->NativeListeners, Outparames, false);
+	bHasInvalidListeners |= DispatchToNativeListeners(Snapshot->NativeListeners, Outparames, true);
+
+	if (bHasInvalidListeners)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		RemoveInvalidListeners(Shard, Key);
+	}
+}
+
+void FEventChannel::NotifyEventToListeners(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames, const TArray<FEventHandle>& Targets)
+{
+	check(IsInGameThread());
+	const FEventKey Key = FEventKey::Find(EventId);
+	if (!Key.IsValid())
+	{
+		return;
+	}
+	FShard& Shard = GetShard(Key);
+
+	// Group the targets by class like the registry does, with only the targeted instances
+	struct FTargetGroup
+	{
+		int32 ClassIndex;
+		TArray<TWeakObjectPtr<UObject>, TInlineAllocator<8>> Instances;
+	};
+	TArray<FTargetGroup, TInlineAllocator<4>> Groups;
+	FEventListenerSnapshotPtr Snapshot;
+	{
+		FScopeLock Lock(&Shard.Lock);
+		FEventListeners* ListenersPtr = Shard.ListenerMap.Find(Key);
+		if (!ListenersPtr || !Targets.Num()) return;
+
+		FEventSchema& Schema = Shard.Schemas.FindChecked(Key);
+		if (!PrepareNotify(Shard, Key, *ListenersPtr, Schema, Sender, Outparames))
+		{
+			return;
+		}
+
+		// The snapshot is current under the lock, its classes are in the order of the registry
+		Snapshot = ListenersPtr->GetSnapshot();
+		for (const FEventHandle& Target : Targets)
+		{
+			UObject* Listener = Target.Listener.Get();
+			FEventClassListeners* ClassListeners = Listener && ListenersPtr->Handles.Contains(Target) ? ListenersPtr->FindClass(Listener->GetClass(), Target.EventName) : nullptr;
+			if (!ClassListeners)
+			{
+				continue;
+			}
+
+			const int32 ClassIndex = UE_PTRDIFF_TO_INT32(ClassListeners - ListenersPtr->Classes.GetData());
+			FTargetGroup* Group = Groups.FindByPredicate([ClassIndex](const FTargetGroup& Other) { return Other.ClassIndex == ClassIndex; });
+			if (!Group)
+			{
+				Group = &Groups.AddDefaulted_GetRef();
+				Group->ClassIndex = ClassIndex;
+			}
+			Group->Instances.Add(Listener);
+		}
+	}
+
+	for (const FTargetGroup& Group : Groups)
+	{
+		DispatchToClass(Snapshot->Classes[Group.ClassIndex], Group.Instances, Outparames);
+	}
+}
+
+bool FEventChannel::PrepareNotify(FShard& Shard, FEventKey Key, const FEventListeners& Listeners, FEventSchema& Schema, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	if (!Schema.HasLayout())
+	{
+		// The layout function was collected, any remaining listener was validated against it and can take over
+		for (const FEventClassListeners& ClassListeners : Listeners.Classes)
+		{
+			if (UFunction* Function = ClassListeners.Function.Get())
+			{
+				Schema.BindLayout(Function);
+				break;
+			}
+		}
+	}
+
+	FString Error;
+	if (!Schema.ValidatePayload(Params, Error))
+	{
+		ReportMismatchOnce(Key.GetEventId(), FString::Printf(TEXT("Dropped notify of %s: %s"), *Key.GetEventId(), *Error));
+		return false;
+	}
+
+	if (Schema.Throttle.IsActive() && !PassThrottle(Shard, Key, Schema, Sender, Params))
+	{
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&OnNotifyLock);
+		// Observers get the declared layout when there is one, it doesn't change with whoever listens
+		OnNotify.Broadcast(Key.GetEventId(), Sender, Params, Schema.GetDeclaredLayout().Num() ? Schema.GetDeclaredLayout() : Schema.GetPayloadLayout());
+	}
+	return true;
+}
+
+bool FEventChannel::DispatchToListeners(const TArray<FEventClassListeners>& Classes, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	bool bHasInvalidListeners = false;
+	for (const FEventClassListeners& ClassListeners : Classes)
+	{
+		bHasInvalidListeners |= DispatchToClass(ClassListeners, ClassListeners.Instances, Params);
+	}
+	return bHasInvalidListeners;
+}
+
+bool FEventChannel::DispatchToClass(const FEventClassListeners& ClassListeners, TArrayView<const TWeakObjectPtr<UObject>> Instances, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	UFunction* Function = ClassListeners.Function.Get();
+	if (!Function)
+	{
+		return true;
+	}
+
+	bool bHasInvalidListeners = false;
+
+	// Function and payload were both checked against the schema, copy straight through
+	uint8* FunctionParams = (uint8*)FMemory_Alloca(Function->ParmsSize);
+	for (const TWeakObjectPtr<UObject>& Instance : Instances)
+	{
+		UObject* Listener = Instance.Get();
+		if (!Listener)
+		{
+			bHasInvalidListeners = true;
+			continue;
+		}
+
+		// FIX (blowpunch)
+		if (Listener->IsPendingKillOrUnreachable())
+		{
+			UE_LOG(EventSystem, Warning, TEXT("Listener %s is pending kill or unreachable!"), *Listener->GetFName().ToString());
+			continue;
+		}
+		///
+
+		FMemory::Memzero(FunctionParams, Function->ParmsSize);
+		for (int32 Index = 0; Index < ClassListeners.Parameters.Num(); ++Index)
+		{
+			FProperty* Prop = ClassListeners.Parameters[Index];
+			Prop->InitializeValue_InContainer(FunctionParams);
+			Prop->CopyCompleteValue(Prop->ContainerPtrToValuePtr<void>(FunctionParams), Params[Index].PropAddr);
+		}
+		Listener->ProcessEvent(Function, FunctionParams);
+
+		for (FProperty* Prop : ClassListeners.Parameters)
+		{
+			Prop->DestroyValue_InContainer(FunctionParams);
+		}
+		if (ClassListeners.ReturnProperty)
+		{
+			ClassListeners.ReturnProperty->DestroyValue_InContainer(FunctionParams);
+		}
+	}
+
+	return bHasInvalidListeners;
+}
+
+bool FEventChannel::DispatchToNativeListeners(const TArray<FEventNativeListener>& NativeListeners, const TArray<FOutputParam, TInlineAllocator<8>>& Params, bool bAnyThread)
+{
+	TArray<const FEventNativeListener*, TInlineAllocator<16>> ToRun;
+	bool bHasInvalidListeners = false;
+
+	for (const FEventNativeListener& Native : NativeListeners)
+	{
+		if (Native.bAnyThread != bAnyThread)
+		{
+			continue;
+		}
+
+		if (!Native.IsValid())
+		{
+			bHasInvalidListeners = true;
+			continue;
+		}
+		ToRun.Add(&Native);
+	}
+
+	if (bAnyThread && ToRun.Num() >= EventParallelDispatchThreshold)
+	{
+		ParallelFor(ToRun.Num(), [&ToRun, &Params](int32 Index)
+		{
+			ToRun[Index]->Callback.ExecuteIfBound(Params);
+		});
+	}
+	else
+	{
+		for (const FEventNativeListener* Native : ToRun)
+		{
+			Native->Callback.ExecuteIfBound(Params);
+		}
+	}
+
+	return bHasInvalidListeners;
+}
+
+void FEventChannel::RemoveInvalidListeners(FShard& Shard, FEventKey Key)
+{
+	FEventListeners* Listeners = Shard.ListenerMap.Find(Key);
+	if (!Listeners)
+	{
+		return;
+	}
+
+	const FName MsgID = FName(*Key.GetEventId());
+	for (int32 ClassIndex = Listeners->Classes.Num() - 1; ClassIndex >= 0; --ClassIndex)
+	{
+		FEventClassListeners& ClassListeners = Listeners->Classes[ClassIndex];
+		if (!ClassListeners.Function.IsValid())
+		{
+			// The function went away with its class, forget the instances so they can listen again
+			for (const TWeakObjectPtr<UObject>& Instance : ClassListeners.Instances)
+			{
+				Listeners->Handles.Remove(FEventHandle(Instance.Get(), ClassListeners.EventName, MsgID, Scope));
+			}
+			ClassListeners.Instances.Reset();
+		}
+
+		ClassListeners.Instances.RemoveAllSwap([](const TWeakObjectPtr<UObject>& Instance) { return !Instance.IsValid(); });
+		if (!ClassListeners.Instances.Num())
+		{
+			Listeners->Classes.RemoveAtSwap(ClassIndex);
+		}
+	}
+
+	for (auto It = Listeners->Handles.CreateIterator(); It; ++It)
+	{
+		if (!It->Listener.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	Listeners->NativeListeners.RemoveAll([](const FEventNativeListener& Native) { return !Native.IsValid(); });
+	Listeners->InvalidateSnapshot();
+
+	if (Listeners->IsEmpty()) Shard.ListenerMap.Remove(Key);
+	UE_LOG(EventSystem, Log, TEXT("Removed invalid listeners."));
+}
+
+const FEventHandle FEventChannel::ListenEvent(const FString& MessageId, UObject* Listener, FName EventName)
+{
+	if (!Listener)
+	{
+		return FEventHandle();
+	}
+
+	FName MsgID = FName (*MessageId);
+	FEventHandle Lis(Listener, EventName, MsgID, Scope);
+
+	const FEventKey Key = FEventKey::FindOrAdd(MessageId);
+	FShard& Shard = GetShard(Key);
+	FScopeLock Lock(&Shard.Lock);
+
+	FEventListeners* Listeners = Shard.ListenerMap.Find(Key);
+	if (Listeners && Listeners->Handles.Contains(Lis))
+	{
+		return Lis;
+	}
+
+	// Another instance of the same class already resolved and validated the function
+	UClass* Class = Listener->GetClass();
+	if (FEventClassListeners* ClassListeners = Listeners ? Listeners->FindClass(Class, EventName) : nullptr)
+	{
+		if (ClassListeners->Function.IsValid())
+		{
+			ClassListeners->Instances.Add(Listener);
+			Listeners->Handles.Add(Lis);
+			Listeners->InvalidateSnapshot();
+			return Lis;
+		}
+	}
+
+	UFunction* Function = Listener->FindFunction(EventName);
+	if (!Function)
+	{
+		ReportMismatchOnce(MessageId + TEXT("/") + EventName.ToString(),
+			FString::Printf(TEXT("Listener %s of %s has no function %s"), *Listener->GetName(), *MessageId, *EventName.ToString()));
+		return FEventHandle();
+	}
+
+	FEventSchema& Schema = FindOrAddSchema(Shard, Key);
+	FString Error;
+	if (!Schema.ValidateFunction(Function, Error))
+	{
+		ReportMismatchOnce(MessageId + TEXT("/") + Function->GetPathName(),
+			FString::Printf(TEXT("Refused listener %s of %s: %s"), *Listener->GetName(), *MessageId, *Error));
+		return FEventHandle();
+	}
+
+	if (!Schema.HasLayout())
+	{
+		Schema.BindLayout(Function);
+	}
+
+	Listeners = &Shard.ListenerMap.FindOrAdd(Key);
+	FEventClassListeners* ClassListeners = Listeners->FindClass(Class, EventName);
+	if (!ClassListeners)
+	{
+		ClassListeners = &Listeners->Classes.AddDefaulted_GetRef();
+		ClassListeners->Class = Class;
+		ClassListeners->EventName = EventName;
+	}
+
+	// (Re)build the plan, a stale one means the class was recompiled
+	ClassListeners->Function = Function;
+	ClassListeners->Parameters.Reset();
+	FEventSchema::GetParameters(Function, ClassListeners->Parameters);
+	ClassListeners->ReturnProperty = Function->GetReturnProperty();
+
+	ClassListeners->Instances.Add(Listener);
+	Listeners->Handles.Add(Lis);
+	Listeners->InvalidateSnapshot();
+	return Lis;
+}
+
+bool FEventChannel::RemoveListener(FEventListeners& Listeners, const FEventHandle& Handle)
+{
+	if (!Listeners.Handles.Remove(Handle))
+	{
+		return false;
+	}
+	Listeners.InvalidateSnapshot();
+
+	UObject* Listener = Handle.Listener.Get();
+	if (FEventClassListeners* ClassListeners = Listener ? Listeners.FindClass(Listener->GetClass(), Handle.EventName) : nullptr)
+	{
+		ClassListeners->Instances.RemoveSingleSwap(Handle.Listener);
+		if (!ClassListeners->Instances.Num())
+		{
+			Listeners.Classes.RemoveAtSwap(UE_PTRDIFF_TO_INT32(ClassListeners - Listeners.Classes.GetData()));
+		}
+	}
+	return true;
+}
+
+void FEventChannel::UnListenEvent(const FEventHandle& InHandle)
+{
+	const FEventKey Key = FEventKey::Find(InHandle.MsgId.ToString());
+	if (!Key.IsValid())
+	{
+		return;
+	}
+
+	FShard& Shard = GetShard(Key);
+	FScopeLock Lock(&Shard.Lock);
+	if (FEventListeners* Listeners = Shard.ListenerMap.Find(Key))
+	{
+		RemoveListener(*Listeners, InHandle);
+		if (Listeners->IsEmpty())
+		{
+			Shard.ListenerMap.Remove(Key);
+		}
+	}
+}
+
+// FIX (blowpunch)
+void FEventChannel::UnListenEvents(UObject* Listener)
+{
+	TArray<FEventHandle, TInlineAllocator<8>> HandlesToRemove;
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		for (auto It = Shard.ListenerMap.CreateIterator(); It; ++It)
+		{
+			HandlesToRemove.Reset();
+			for (const FEventHandle& Handle : It->Value.Handles)
+			{
+				if (Handle.Listener.Get() == Listener) HandlesToRemove.Add(Handle);
+			}
+
+			for (const FEventHandle& Handle : HandlesToRemove)
+			{
+				RemoveListener(It->Value, Handle);
+			}
+
+			if (It->Value.NativeListeners.RemoveAll([Listener](const FEventNativeListener& Native) { return Native.bHasOwner && Native.Owner.Get() == Listener; }))
+			{
+				It->Value.InvalidateSnapshot();
+			}
+
+			if (It->Value.IsEmpty()) It.RemoveCurrent();
+		}
+	}
+}
+///
+
+FDelegateHandle FEventChannel::ListenEventNative(const FString& EventId, FOnEventNotified Callback, const UObject* Owner, bool bAnyThread)
+{
+	return ListenEventNative(FEventKey::FindOrAdd(EventId), MoveTemp(Callback), Owner, bAnyThread);
+}
+
+FDelegateHandle FEventChannel::ListenEventNative(FEventKey Key, FOnEventNotified Callback, const UObject* Owner, bool bAnyThread)
+{
+	check(Key.IsValid());
+	FShard& Shard = GetShard(Key);
+	FScopeLock Lock(&Shard.Lock);
+
+	// Native listeners don't describe a layout, they still make sure the event has a schema to check payloads with
+	FindOrAddSchema(Shard, Key);
+
+	FEventListeners& Listeners = Shard.ListenerMap.FindOrAdd(Key);
+	Listeners.InvalidateSnapshot();
+
+	FEventNativeListener& Native = Listeners.NativeListeners.AddDefaulted_GetRef();
+	Native.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	Native.Callback = MoveTemp(Callback);
+	Native.Owner = Owner;
+	Native.bHasOwner = Owner != nullptr;
+	Native.bAnyThread = bAnyThread;
+	return Native.Handle;
+}
+
+void FEventChannel::UnListenEventNative(const FString& EventId, FDelegateHandle Handle)
+{
+	const FEventKey Key = FEventKey::Find(EventId);
+	if (Key.IsValid())
+	{
+		UnListenEventNative(Key, Handle);
+	}
+}
+
+void FEventChannel::UnListenEventNative(FEventKey Key, FDelegateHandle Handle)
+{
+	FShard& Shard = GetShard(Key);
+	FScopeLock Lock(&Shard.Lock);
+	if (FEventListeners* Listeners = Shard.ListenerMap.Find(Key))
+	{
+		Listeners->NativeListeners.RemoveAll([Handle](const FEventNativeListener& Native) { return Native.Handle == Handle; });
+		Listeners->InvalidateSnapshot();
+		if (Listeners->IsEmpty())
+		{
+			Shard.ListenerMap.Remove(Key);
+		}
+	}
+}
+
+FDelegateHandle FEventChannel::AddOnNotify(FOnEventChannelNotify::FDelegate Observer)
+{
+	FScopeLock Lock(&OnNotifyLock);
+	return OnNotify.Add(MoveTemp(Observer));
+}
+
+void FEventChannel::RemoveOnNotify(FDelegateHandle Handle)
+{
+	FScopeLock Lock(&OnNotifyLock);
+	OnNotify.Remove(Handle);
+}
+
+bool FEventChannel::GetLayout(const FString& EventId, FEventSchema::FParameterList& OutLayout)
+{
+	const FEventKey Key = FEventKey::FindOrAdd(EventId);
+	FShard& Shard = GetShard(Key);
+	FScopeLock Lock(&Shard.Lock);
+	// Events nobody listens to still have their declaration, which is enough to copy and pack payloads
+	const FEventSchema& Schema = FindOrAddSchema(Shard, Key);
+	if (!Schema.HasPayloadLayout())
+	{
+		return false;
+	}
+
+	OutLayout = Schema.GetPayloadLayout();
+	return true;
+}
+
+bool FEventChannel::GetDeclaredLayout(const FString& EventId, FEventSchema::FParameterList& OutLayout)
+{
+	const FEventKey Key = FEventKey::FindOrAdd(EventId);
+	FShard& Shard = GetShard(Key);
+	FScopeLock Lock(&Shard.Lock);
+	const FEventSchema& Schema = FindOrAddSchema(Shard, Key);
+	if (!Schema.GetDeclaredLayout().Num())
+	{
+		return false;
+	}
+
+	OutLayout = Schema.GetDeclaredLayout();
+	return true;
+}
+
+FEventSchema& FEventChannel::FindOrAddSchema(FShard& Shard, FEventKey Key)
+{
+	if (FEventSchema* Schema = Shard.Schemas.Find(Key))
+	{
+		return *Schema;
+	}
+
+	FEventSchema& Schema = Shard.Schemas.Add(Key);
+	TArray<FEventParameterDesc> Parameters;
+	if (ResolveEventParameters.IsBound() && ResolveEventParameters.Execute(FName(*Key.GetEventId()), Parameters, Schema.Throttle) && Parameters.Num())
+	{
+		FString Error;
+		if (!Schema.SetDeclaration(Parameters, Error))
+		{
+			UE_LOG(EventSystem, Warning, TEXT("Ignoring declaration of %s: %s"), *Key.GetEventId(), *Error);
+		}
+	}
+	return Schema;
+}
+
+bool FEventChannel::PassThrottle(FShard& Shard, FEventKey Key, const FEventSchema& Schema, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	FEventThrottleState& State = Shard.Throttles.FindOrAdd(Key);
+	const double Now = FPlatformTime::Seconds();
+	if (State.CanDeliver(Schema.Throttle, Now))
+	{
+		State.Consume(Schema.Throttle, Now);
+
+		// This notify is newer than anything pending
+		State.PendingPayload.Reset();
+		return true;
+	}
+
+	if (Schema.Throttle.bDeliverTrailing && Schema.HasPayloadLayout())
+	{
+		const bool bWasPending = State.PendingPayload.IsValid();
+		State.PendingPayload = MakeShared<FEventPayload, ESPMode::ThreadSafe>(Schema.GetPayloadLayout(), Params);
+		State.PendingSender = Sender;
+		if (!bWasPending)
+		{
+			ScheduleTrailingFlush();
+		}
+	}
+	return false;
+}
+
+void FEventChannel::ScheduleTrailingFlush()
+{
+	if (!IsInGameThread())
+	{
+		TSharedRef<FEventChannel*, ESPMode::ThreadSafe> Token = SelfToken;
+		AsyncTask(ENamedThreads::GameThread, [Token]()
+		{
+			if (FEventChannel* Channel = *Token)
+			{
+				Channel->ScheduleTrailingFlush();
+			}
+		});
+		return;
+	}
+
+	if (!TrailingFlushHandle.IsValid())
+	{
+		TrailingFlushHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEventChannel::FlushTrailingNotifies));
+	}
+}
+
+bool FEventChannel::FlushTrailingNotifies(float DeltaTime)
+{
+	struct FTrailingNotify
+	{
+		FEventKey Key;
+		FEventPayloadPtr Payload;
+		TWeakObjectPtr<UObject> Sender;
+	};
+	TArray<FTrailingNotify> Ready;
+	bool bHasPending = false;
+
+	const double Now = FPlatformTime::Seconds();
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		for (auto& Pair : Shard.Throttles)
+		{
+			FEventThrottleState& State = Pair.Value;
+			if (!State.PendingPayload.IsValid())
+			{
+				continue;
+			}
+
+			const FEventSchema* Schema = Shard.Schemas.Find(Pair.Key);
+			if (Schema && State.CanDeliver(Schema->Throttle, Now))
+			{
+				Ready.Add({ Pair.Key, MoveTemp(State.PendingPayload), State.PendingSender });
+				State.PendingPayload.Reset();
+			}
+			else
+			{
+				bHasPending = true;
+			}
+		}
+	}
+
+	// Forget the ticker first, a delivery that gets suppressed again schedules a new one
+	if (!bHasPending)
+	{
+		TrailingFlushHandle.Reset();
+	}
+
+	// Delivered like any other notify, which consumes the throttle again
+	for (const FTrailingNotify& Notify : Ready)
+	{
+		NotifyEventWithParams(Notify.Key, Notify.Sender.Get(), Notify.Payload->Values);
+	}
+	return bHasPending;
+}
+
+void FEventChannel::ReportMismatchOnce(const FString& Key, const FString& Message)
+{
+	bool bAlreadyReported = false;
+	{
+		FScopeLock Lock(&ReportedMismatchesLock);
+		ReportedMismatches.Add(Key, &bAlreadyReported);
+	}
+	if (!bAlreadyReported)
+	{
+		UE_LOG(EventSystem, Error, TEXT("%s"), *Message);
+	}
+}
+
+void FEventChannel::Reset()
+{
+	for (FShard& Shard : Shards)
+	{
+		FScopeLock Lock(&Shard.Lock);
+		Shard.ListenerMap.Empty();
+		Shard.Schemas.Empty();
+		Shard.Throttles.Empty();
+	}
+
+	FScopeLock Lock(&ReportedMismatchesLock);
+	ReportedMismatches.Empty();
+}
@@ -0,0 +1,75 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "Systems/EventKey.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace EventKeyRegistry
+{
+	/** Ids live in fixed chunks that never move, so GetEventId reads them without the lock */
+	static const int32 ChunkSize = 4096;
+	static const int32 MaxChunks = 1024;
+
+	struct FRegistry
+	{
+		FRWLock Lock;
+		TMap<FString, int32> Ids;
+		FString* Chunks[MaxChunks] = {};
+		int32 NumIds = 0;
+	};
+
+	static FRegistry& Get()
+	{
+		static FRegistry Registry;
+		return Registry;
+	}
+}
+
+FEventKey FEventKey::FindOrAdd(const FString& EventId)
+{
+	const FEventKey Existing = Find(EventId);
+	if (Existing.IsValid())
+	{
+		return Existing;
+	}
+
+	EventKeyRegistry::FRegistry& Registry = EventKeyRegistry::Get();
+	FRWScopeLock Lock(Registry.Lock, SLT_Write);
+	if (const int32* Id = Registry.Ids.Find(EventId))
+	{
+		return FEventKey(*Id);
+	}
+
+	const int32 Id = Registry.NumIds;
+	const int32 Chunk = Id / EventKeyRegistry::ChunkSize;
+	checkf(Chunk < EventKeyRegistry::MaxChunks, TEXT("Too many event ids registered"));
+	if (!Registry.Chunks[Chunk])
+	{
+		Registry.Chunks[Chunk] = new FString[EventKeyRegistry::ChunkSize];
+	}
+
+	// The id is in place before the key is handed out, readers holding a key never see an empty slot
+	Registry.Chunks[Chunk][Id % EventKeyRegistry::ChunkSize] = EventId;
+	Registry.Ids.Add(EventId, Id);
+	++Registry.NumIds;
+	return FEventKey(Id);
+}
+
+FEventKey FEventKey::Find(const FString& EventId)
+{
+	EventKeyRegistry::FRegistry& Registry = EventKeyRegistry::Get();
+	FRWScopeLock Lock(Registry.Lock, SLT_ReadOnly);
+	const int32* Id = Registry.Ids.Find(EventId);
+	return Id ? FEventKey(*Id) : FEventKey();
+}
+
+const FString& FEventKey::GetEventId() const
+{
+	if (!IsValid())
+	{
+		static const FString InvalidId;
+		return InvalidId;
+	}
+
+	const EventKeyRegistry::FRegistry& Registry = EventKeyRegistry::Get();
+	return Registry.Chunks[Id / EventKeyRegistry::ChunkSize][Id % EventKeyRegistry::ChunkSize];
+}
@@ -0,0 +1,314 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "Systems/EventRecorder.h"
+#include "EventSystemRuntime.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Serialization/LargeMemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Package.h"
+
+const uint32 FEventRecorder::FileMagic = 0x474C5645; // 'EVLG'
+const uint32 FEventRecorder::FileVersion = 2;
+
+namespace EventLog
+{
+	/** Reads a string whose length fits in what is left of Ar, false on a truncated or corrupt record */
+	bool ReadString(FArchive& Ar, FString& OutString)
+	{
+		const int64 Start = Ar.Tell();
+		int32 SaveNum = 0;
+		Ar << SaveNum;
+
+		// Negative lengths are UCS2 strings
+		const int64 NumBytes = FMath::Abs((int64)SaveNum) * (SaveNum < 0 ? sizeof(UCS2CHAR) : sizeof(ANSICHAR));
+		if (Ar.IsError() || NumBytes > Ar.TotalSize() - Ar.Tell())
+		{
+			return false;
+		}
+
+		Ar.Seek(Start);
+		Ar << OutString;
+		return !Ar.IsError();
+	}
+
+	/** Reads a byte array whose size fits in what is left of Ar, false on a truncated or corrupt record */
+	bool ReadBytes(FArchive& Ar, TArray<uint8>& OutBytes)
+	{
+		int32 Num = 0;
+		Ar << Num;
+		if (Ar.IsError() || Num < 0 || Num > Ar.TotalSize() - Ar.Tell())
+		{
+			return false;
+		}
+
+		OutBytes.SetNumUninitialized(Num);
+		Ar.Serialize(OutBytes.GetData(), Num);
+		return !Ar.IsError();
+	}
+}
+
+FEventRecorder::~FEventRecorder()
+{
+	Stop();
+}
+
+bool FEventRecorder::Start(FEventChannel& InChannel, const FString& Filename)
+{
+	Stop();
+
+	// Sessions are only appended to a log of this version, anything else is started over
+	bool bAppend = false;
+	{
+		TUniquePtr<FArchive> Existing(IFileManager::Get().CreateFileReader(*Filename));
+		if (Existing.IsValid() && Existing->TotalSize() >= int64(2 * sizeof(uint32)))
+		{
+			uint32 Magic = 0;
+			uint32 Version = 0;
+			*Existing << Magic;
+			*Existing << Version;
+			bAppend = Magic == FileMagic && Version == FileVersion;
+		}
+	}
+
+	Writer.Reset(IFileManager::Get().CreateFileWriter(*Filename, (bAppend ? FILEWRITE_Append : 0) | FILEWRITE_AllowRead));
+	if (!Writer.IsValid())
+	{
+		UE_LOG(EventSystem, Error, TEXT("Can't record events to %s"), *Filename);
+		return false;
+	}
+
+	if (!bAppend)
+	{
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		*Writer << Magic;
+		*Writer << Version;
+	}
+
+	// Timestamps of the entries that follow are relative to this session
+	ERecordType Type = ERecordType::Session;
+	int64 SessionTicks = FDateTime::UtcNow().GetTicks();
+	*Writer << Type;
+	*Writer << SessionTicks;
+
+	StartTime = FPlatformTime::Seconds();
+	Channel = &InChannel;
+	NotifyHandle = Channel->AddOnNotify(FOnEventChannelNotify::FDelegate::CreateRaw(this, &FEventRecorder::OnNotify));
+
+	UE_LOG(EventSystem, Log, TEXT("Recording events to %s"), *Filename);
+	return true;
+}
+
+void FEventRecorder::Stop()
+{
+	if (Channel)
+	{
+		Channel->RemoveOnNotify(NotifyHandle);
+		Channel = nullptr;
+	}
+
+	FScopeLock Lock(&WriterLock);
+	if (Writer.IsValid())
+	{
+		Writer->Close();
+		Writer.Reset();
+	}
+}
+
+void FEventRecorder::OnNotify(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params, const FEventSchema::FParameterList& Layout)
+{
+	// The channel passes the declared layout whenever the dictionary has one, events it doesn't describe can't be recorded
+	if (Layout.Num() != Params.Num())
+	{
+		return;
+	}
+
+	TArray<uint8> PayloadBytes;
+	{
+		FMemoryWriter MemoryWriter(PayloadBytes);
+		FObjectAndNameAsStringProxyArchive Ar(MemoryWriter, false);
+		FEventPayload::SerializeValues(Ar, Layout, Params);
+	}
+
+	double Time = FPlatformTime::Seconds() - StartTime;
+	FString EventIdCopy = EventId;
+	FString SenderPath = GetPathNameSafe(Sender);
+
+	ERecordType Type = ERecordType::Notify;
+
+	FScopeLock Lock(&WriterLock);
+	if (Writer.IsValid())
+	{
+		*Writer << Type;
+		*Writer << Time;
+		*Writer << EventIdCopy;
+		*Writer << SenderPath;
+		*Writer << PayloadBytes;
+	}
+}
+
+FEventReplayer::~FEventReplayer()
+{
+	Stop();
+}
+
+bool FEventReplayer::Start(FEventChannel& InChannel, const FString& Filename, float PlaybackRate)
+{
+	Stop();
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (!MappedRegion.IsValid())
+	{
+		UE_LOG(EventSystem, Error, TEXT("Can't map event log %s"), *Filename);
+		Stop();
+		return false;
+	}
+
+	// Reads past the end flag an error instead of asserting, a log cut short by a crash replays up to its last whole entry
+	Reader = MakeUnique<FLargeMemoryReader>(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic;
+	*Reader << Version;
+	if (Magic != FEventRecorder::FileMagic || Version != FEventRecorder::FileVersion)
+	{
+		UE_LOG(EventSystem, Error, TEXT("%s is not an event log this version can read"), *Filename);
+		Stop();
+		return false;
+	}
+
+	Channel = &InChannel;
+	ReplayTime = 0.0;
+	SessionStart = 0.0;
+	LastEntryTime = 0.0;
+	Rate = PlaybackRate;
+	NumSkipped = 0;
+
+	if (Rate <= 0.f)
+	{
+		ReplayUntil(TNumericLimits<double>::Max());
+		Stop();
+		return true;
+	}
+
+	TickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEventReplayer::Tick));
+	return true;
+}
+
+void FEventReplayer::Stop()
+{
+	if (TickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+
+	if (NumSkipped)
+	{
+		UE_LOG(EventSystem, Warning, TEXT("Event replay skipped %d entries whose event has neither a declaration nor a listener layout"), NumSkipped);
+		NumSkipped = 0;
+	}
+
+	Reader.Reset();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Channel = nullptr;
+}
+
+bool FEventReplayer::Tick(float DeltaTime)
+{
+	ReplayTime += DeltaTime * Rate;
+	if (!ReplayUntil(ReplayTime))
+	{
+		TickHandle.Reset();
+		Stop();
+		return false;
+	}
+	return true;
+}
+
+bool FEventReplayer::ReplayUntil(double Time)
+{
+	while (!Reader->AtEnd())
+	{
+		const int64 EntryStart = Reader->Tell();
+		FEventRecorder::ERecordType Type = FEventRecorder::ERecordType::Notify;
+		*Reader << Type;
+		if (Type == FEventRecorder::ERecordType::Session)
+		{
+			// A later session continues where the previous one left off
+			int64 SessionTicks = 0;
+			*Reader << SessionTicks;
+			if (Reader->IsError())
+			{
+				break;
+			}
+			SessionStart = LastEntryTime;
+			continue;
+		}
+		if (Type != FEventRecorder::ERecordType::Notify)
+		{
+			Reader->SetError();
+			break;
+		}
+
+		double EntryTime = 0.0;
+		*Reader << EntryTime;
+		if (Reader->IsError())
+		{
+			break;
+		}
+
+		EntryTime += SessionStart;
+		if (EntryTime > Time)
+		{
+			Reader->Seek(EntryStart);
+			return true;
+		}
+
+		FString EventId;
+		FString SenderPath;
+		TArray<uint8> PayloadBytes;
+		if (!EventLog::ReadString(*Reader, EventId) || !EventLog::ReadString(*Reader, SenderPath) || !EventLog::ReadBytes(*Reader, PayloadBytes))
+		{
+			Reader->SetError();
+			break;
+		}
+		LastEntryTime = EntryTime;
+
+		// Payloads were recorded with the declared layout when there is one, read them back the same way
+		FEventSchema::FParameterList Layout;
+		if (!Channel->GetDeclaredLayout(EventId, Layout) && !Channel->GetLayout(EventId, Layout) && PayloadBytes.Num())
+		{
+			++NumSkipped;
+			continue;
+		}
+
+		FEventPayload Payload(Layout);
+		FMemoryReader MemoryReader(PayloadBytes);
+		FObjectAndNameAsStringProxyArchive Ar(MemoryReader, false);
+		Payload.Serialize(Ar);
+		if (Ar.IsError())
+		{
+			++NumSkipped;
+			continue;
+		}
+
+		UObject* Sender = SenderPath.IsEmpty() || SenderPath == TEXT("None") ? nullptr : StaticFindObject(UObject::StaticClass(), nullptr, *SenderPath);
+		Channel->NotifyEventWithParams(EventId, Sender, Payload.Values);
+	}
+
+	UE_CLOG(Reader->IsError(), EventSystem, Warning, TEXT("Event log is truncated or corrupt at offset %lld, replay stopped at its last whole entry"), Reader->Tell());
+	return false;
+}
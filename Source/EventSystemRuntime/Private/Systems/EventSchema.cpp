@@ -0,0 +1,503 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "Systems/EventSchema.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "JsonUtilities/Public/JsonObjectConverter.h"
+#include "Serialization/StructuredArchive.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	// Mirrors the UEdGraphSchema_K2 pin categories, which are not available outside the editor
+	static const FName PC_Boolean(TEXT("bool"));
+	static const FName PC_Byte(TEXT("byte"));
+	static const FName PC_Int(TEXT("int"));
+	static const FName PC_Int64(TEXT("int64"));
+	static const FName PC_Float(TEXT("float"));
+	static const FName PC_Name(TEXT("name"));
+	static const FName PC_String(TEXT("string"));
+	static const FName PC_Text(TEXT("text"));
+	static const FName PC_Struct(TEXT("struct"));
+	static const FName PC_Object(TEXT("object"));
+	static const FName PC_Class(TEXT("class"));
+	static const FName PC_SoftObject(TEXT("softobject"));
+	static const FName PC_SoftClass(TEXT("softclass"));
+	static const FName PC_Interface(TEXT("interface"));
+
+	bool PropertyMatchesTerminal(const FProperty* Property, FName Category, const UObject* SubCategoryObject)
+	{
+		if (!Property)
+		{
+			return false;
+		}
+
+		if (Category == PC_Boolean)
+		{
+			return Property->IsA<FBoolProperty>();
+		}
+		if (Category == PC_Byte)
+		{
+			const UEnum* Enum = Cast<const UEnum>(SubCategoryObject);
+			if (const FByteProperty* ByteProperty = CastField<const FByteProperty>(Property))
+			{
+				return !Enum || ByteProperty->Enum == Enum;
+			}
+			if (const FEnumProperty* EnumProperty = CastField<const FEnumProperty>(Property))
+			{
+				return !Enum || EnumProperty->GetEnum() == Enum;
+			}
+			return false;
+		}
+		if (Category == PC_Int)
+		{
+			return Property->IsA<FIntProperty>();
+		}
+		if (Category == PC_Int64)
+		{
+			return Property->IsA<FInt64Property>();
+		}
+		if (Category == PC_Float)
+		{
+			return Property->IsA<FFloatProperty>();
+		}
+		if (Category == PC_Name)
+		{
+			return Property->IsA<FNameProperty>();
+		}
+		if (Category == PC_String)
+		{
+			return Property->IsA<FStrProperty>();
+		}
+		if (Category == PC_Text)
+		{
+			return Property->IsA<FTextProperty>();
+		}
+		if (Category == PC_Struct)
+		{
+			const FStructProperty* StructProperty = CastField<const FStructProperty>(Property);
+			return StructProperty && StructProperty->Struct == SubCategoryObject;
+		}
+		if (Category == PC_Class)
+		{
+			const FClassProperty* ClassProperty = CastField<const FClassProperty>(Property);
+			return ClassProperty && (!SubCategoryObject || ClassProperty->MetaClass == SubCategoryObject);
+		}
+		if (Category == PC_SoftClass)
+		{
+			const FSoftClassProperty* ClassProperty = CastField<const FSoftClassProperty>(Property);
+			return ClassProperty && (!SubCategoryObject || ClassProperty->MetaClass == SubCategoryObject);
+		}
+		if (Category == PC_Object)
+		{
+			const FObjectProperty* ObjectProperty = CastField<const FObjectProperty>(Property);
+			return ObjectProperty && !Property->IsA<FClassProperty>() && (!SubCategoryObject || ObjectProperty->PropertyClass == SubCategoryObject);
+		}
+		if (Category == PC_SoftObject)
+		{
+			const FSoftObjectProperty* ObjectProperty = CastField<const FSoftObjectProperty>(Property);
+			return ObjectProperty && !Property->IsA<FSoftClassProperty>() && (!SubCategoryObject || ObjectProperty->PropertyClass == SubCategoryObject);
+		}
+		if (Category == PC_Interface)
+		{
+			const FInterfaceProperty* InterfaceProperty = CastField<const FInterfaceProperty>(Property);
+			return InterfaceProperty && (!SubCategoryObject || InterfaceProperty->InterfaceClass == SubCategoryObject);
+		}
+
+		// Unknown categories (delegates, field paths...) can't be checked here, let SameType against the layout decide
+		return true;
+	}
+
+	bool PropertyMatchesPinType(const FProperty* Property, const FEdGraphPinType& PinType)
+	{
+		const FName Category = PinType.PinCategory;
+		const UObject* SubCategoryObject = PinType.PinSubCategoryObject.Get();
+
+		switch (PinType.ContainerType)
+		{
+		case EPinContainerType::Array:
+		{
+			const FArrayProperty* ArrayProperty = CastField<const FArrayProperty>(Property);
+			return ArrayProperty && PropertyMatchesTerminal(ArrayProperty->Inner, Category, SubCategoryObject);
+		}
+		case EPinContainerType::Set:
+		{
+			const FSetProperty* SetProperty = CastField<const FSetProperty>(Property);
+			return SetProperty && PropertyMatchesTerminal(SetProperty->ElementProp, Category, SubCategoryObject);
+		}
+		case EPinContainerType::Map:
+		{
+			const FMapProperty* MapProperty = CastField<const FMapProperty>(Property);
+			return MapProperty
+				&& PropertyMatchesTerminal(MapProperty->KeyProp, Category, SubCategoryObject)
+				&& PropertyMatchesTerminal(MapProperty->ValueProp, PinType.PinValueType.TerminalCategory, PinType.PinValueType.TerminalSubCategoryObject.Get());
+		}
+		default:
+			return PropertyMatchesTerminal(Property, Category, SubCategoryObject);
+		}
+	}
+
+	/** Makes a standalone property holding values of a terminal pin type, null for types that have no runtime property */
+	FProperty* MakeTerminalProperty(FFieldVariant Owner, FName Name, FName Category, UObject* SubCategoryObject)
+	{
+		const EObjectFlags Flags = RF_Transient;
+		UClass* Class = Cast<UClass>(SubCategoryObject);
+
+		if (Category == PC_Boolean)
+		{
+			FBoolProperty* Property = new FBoolProperty(Owner, Name, Flags);
+			Property->SetBoolSize(sizeof(bool), true);
+			return Property;
+		}
+		if (Category == PC_Byte)
+		{
+			FByteProperty* Property = new FByteProperty(Owner, Name, Flags);
+			Property->Enum = Cast<UEnum>(SubCategoryObject);
+			return Property;
+		}
+		if (Category == PC_Int)
+		{
+			return new FIntProperty(Owner, Name, Flags);
+		}
+		if (Category == PC_Int64)
+		{
+			return new FInt64Property(Owner, Name, Flags);
+		}
+		if (Category == PC_Float)
+		{
+			return new FFloatProperty(Owner, Name, Flags);
+		}
+		if (Category == PC_Name)
+		{
+			return new FNameProperty(Owner, Name, Flags);
+		}
+		if (Category == PC_String)
+		{
+			return new FStrProperty(Owner, Name, Flags);
+		}
+		if (Category == PC_Text)
+		{
+			return new FTextProperty(Owner, Name, Flags);
+		}
+		if (Category == PC_Struct)
+		{
+			UScriptStruct* Struct = Cast<UScriptStruct>(SubCategoryObject);
+			if (!Struct)
+			{
+				return nullptr;
+			}
+			FStructProperty* Property = new FStructProperty(Owner, Name, Flags);
+			Property->Struct = Struct;
+			return Property;
+		}
+		if (Category == PC_Object)
+		{
+			FObjectProperty* Property = new FObjectProperty(Owner, Name, Flags);
+			Property->PropertyClass = Class ? Class : UObject::StaticClass();
+			return Property;
+		}
+		if (Category == PC_Class)
+		{
+			FClassProperty* Property = new FClassProperty(Owner, Name, Flags);
+			Property->PropertyClass = UClass::StaticClass();
+			Property->MetaClass = Class ? Class : UObject::StaticClass();
+			return Property;
+		}
+		if (Category == PC_SoftObject)
+		{
+			FSoftObjectProperty* Property = new FSoftObjectProperty(Owner, Name, Flags);
+			Property->PropertyClass = Class ? Class : UObject::StaticClass();
+			return Property;
+		}
+		if (Category == PC_SoftClass)
+		{
+			FSoftClassProperty* Property = new FSoftClassProperty(Owner, Name, Flags);
+			Property->PropertyClass = UClass::StaticClass();
+			Property->MetaClass = Class ? Class : UObject::StaticClass();
+			return Property;
+		}
+		if (Category == PC_Interface)
+		{
+			FInterfaceProperty* Property = new FInterfaceProperty(Owner, Name, Flags);
+			Property->InterfaceClass = Class ? Class : UInterface::StaticClass();
+			return Property;
+		}
+		return nullptr;
+	}
+
+	FProperty* MakePinTypeProperty(FName Name, const FEdGraphPinType& PinType)
+	{
+		const FName Category = PinType.PinCategory;
+		UObject* SubCategoryObject = PinType.PinSubCategoryObject.Get();
+		const EObjectFlags Flags = RF_Transient;
+
+		FProperty* Property = nullptr;
+		bool bComplete = true;
+		switch (PinType.ContainerType)
+		{
+		case EPinContainerType::Array:
+		{
+			FArrayProperty* ArrayProperty = new FArrayProperty(FFieldVariant(), Name, Flags);
+			ArrayProperty->Inner = MakeTerminalProperty(ArrayProperty, Name, Category, SubCategoryObject);
+			bComplete = ArrayProperty->Inner != nullptr;
+			Property = ArrayProperty;
+			break;
+		}
+		case EPinContainerType::Set:
+		{
+			FSetProperty* SetProperty = new FSetProperty(FFieldVariant(), Name, Flags);
+			SetProperty->ElementProp = MakeTerminalProperty(SetProperty, Name, Category, SubCategoryObject);
+			bComplete = SetProperty->ElementProp != nullptr;
+			Property = SetProperty;
+			break;
+		}
+		case EPinContainerType::Map:
+		{
+			FMapProperty* MapProperty = new FMapProperty(FFieldVariant(), Name, Flags);
+			MapProperty->KeyProp = MakeTerminalProperty(MapProperty, Name, Category, SubCategoryObject);
+			MapProperty->ValueProp = MakeTerminalProperty(MapProperty, Name, PinType.PinValueType.TerminalCategory, PinType.PinValueType.TerminalSubCategoryObject.Get());
+			bComplete = MapProperty->KeyProp && MapProperty->ValueProp;
+			Property = MapProperty;
+			break;
+		}
+		default:
+			Property = MakeTerminalProperty(FFieldVariant(), Name, Category, SubCategoryObject);
+			bComplete = Property != nullptr;
+			break;
+		}
+
+		// A container of a type without runtime property is as unusable as the type itself
+		if (!bComplete)
+		{
+			delete Property;
+			return nullptr;
+		}
+
+		// Sizes of structs and the layout of sets and maps are only known once linked, values live at offset 0
+		FArchive LinkAr;
+		Property->LinkWithoutChangingOffset(LinkAr);
+		return Property;
+	}
+
+	/** Declared properties, keyed by their exported pin type. Payloads keep raw pointers to them, they live as long as the module */
+	FCriticalSection DeclaredPropertiesLock;
+	TMap<FString, FProperty*> DeclaredProperties;
+
+	FProperty* FindOrAddDeclaredProperty(const FString& Type, const FEdGraphPinType& PinType)
+	{
+		FScopeLock Lock(&DeclaredPropertiesLock);
+		if (FProperty** Property = DeclaredProperties.Find(Type))
+		{
+			return *Property;
+		}
+		return DeclaredProperties.Add(Type, MakePinTypeProperty(*FString::Printf(TEXT("Param%d"), DeclaredProperties.Num()), PinType));
+	}
+}
+
+bool FEventSchema::SetDeclaration(const TArray<FEventParameterDesc>& Parameters, FString& OutError)
+{
+	DeclaredTypes.Reset(Parameters.Num());
+	DeclaredLayout.Reset();
+	bHasDeclaration = false;
+	bDeclaredLayoutComplete = false;
+
+	for (const FEventParameterDesc& Parameter : Parameters)
+	{
+		FEdGraphPinType& PinType = DeclaredTypes.AddDefaulted_GetRef();
+		if (!FJsonObjectConverter::JsonObjectStringToUStruct(Parameter.Type, &PinType, 0, 0))
+		{
+			OutError = FString::Printf(TEXT("parameter %s has an unreadable type"), *Parameter.Name.ToString());
+			DeclaredTypes.Reset();
+			DeclaredLayout.Reset();
+			return false;
+		}
+		DeclaredLayout.Add(FindOrAddDeclaredProperty(Parameter.Type, PinType));
+	}
+
+	bHasDeclaration = true;
+	bDeclaredLayoutComplete = !DeclaredLayout.Contains(nullptr);
+	return true;
+}
+
+void FEventSchema::BindLayout(UFunction* Function)
+{
+	LayoutFunction = Function;
+	Layout.Reset();
+	GetParameters(Function, Layout);
+}
+
+bool FEventSchema::ValidateFunction(const UFunction* Function, FString& OutError) const
+{
+	FParameterList Parameters;
+	GetParameters(Function, Parameters);
+
+	if (bHasDeclaration)
+	{
+		if (Parameters.Num() != DeclaredTypes.Num())
+		{
+			OutError = FString::Printf(TEXT("%s takes %d parameters, the event declares %d"), *Function->GetName(), Parameters.Num(), DeclaredTypes.Num());
+			return false;
+		}
+
+		for (int32 Index = 0; Index < Parameters.Num(); ++Index)
+		{
+			if (!PropertyMatchesPinType(Parameters[Index], DeclaredTypes[Index]))
+			{
+				OutError = FString::Printf(TEXT("%s parameter %d (%s %s) does not match the declared type %s"),
+					*Function->GetName(), Index, *Parameters[Index]->GetCPPType(), *Parameters[Index]->GetName(), *DeclaredTypes[Index].PinCategory.ToString());
+				return false;
+			}
+		}
+	}
+
+	if (HasLayout())
+	{
+		if (Parameters.Num() != Layout.Num())
+		{
+			OutError = FString::Printf(TEXT("%s takes %d parameters, %s takes %d"), *Function->GetName(), Parameters.Num(), *LayoutFunction->GetName(), Layout.Num());
+			return false;
+		}
+
+		for (int32 Index = 0; Index < Parameters.Num(); ++Index)
+		{
+			if (!Parameters[Index]->SameType(Layout[Index]))
+			{
+				OutError = FString::Printf(TEXT("%s parameter %d (%s) does not match %s (%s)"),
+					*Function->GetName(), Index, *Parameters[Index]->GetCPPType(), *LayoutFunction->GetName(), *Layout[Index]->GetCPPType());
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool FEventSchema::ValidatePayload(const TArray<FOutputParam, TInlineAllocator<8>>& Params, FString& OutError) const
+{
+	if (!HasLayout())
+	{
+		return !bHasDeclaration || ValidateDeclaredPayload(Params, OutError);
+	}
+
+	if (Params.Num() != Layout.Num())
+	{
+		OutError = FString::Printf(TEXT("payload has %d parameters, listeners take %d"), Params.Num(), Layout.Num());
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Params.Num(); ++Index)
+	{
+		const FOutputParam& Param = Params[Index];
+		if (!Param.PropAddr)
+		{
+			OutError = FString::Printf(TEXT("payload parameter %d has no value"), Index);
+			return false;
+		}
+
+		if (!ParamMatches(Param, Layout[Index]))
+		{
+			OutError = FString::Printf(TEXT("payload parameter %d does not match %s"), Index, *Layout[Index]->GetCPPType());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FEventSchema::ValidateDeclaredPayload(const TArray<FOutputParam, TInlineAllocator<8>>& Params, FString& OutError) const
+{
+	if (Params.Num() != DeclaredTypes.Num())
+	{
+		OutError = FString::Printf(TEXT("payload has %d parameters, the event declares %d"), Params.Num(), DeclaredTypes.Num());
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Params.Num(); ++Index)
+	{
+		const FOutputParam& Param = Params[Index];
+		if (!Param.PropAddr)
+		{
+			OutError = FString::Printf(TEXT("payload parameter %d has no value"), Index);
+			return false;
+		}
+
+		// Blueprint values are checked like listener functions, native ones against the property made from the declaration
+		const bool bMatches = Param.Property
+			? PropertyMatchesPinType(Param.Property, DeclaredTypes[Index]) && (!DeclaredLayout[Index] || Param.Property->ElementSize == DeclaredLayout[Index]->ElementSize)
+			: ParamMatches(Param, DeclaredLayout[Index]);
+		if (!bMatches)
+		{
+			OutError = FString::Printf(TEXT("payload parameter %d does not match the declared type %s"), Index, *DeclaredTypes[Index].PinCategory.ToString());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FEventSchema::ParamMatches(const FOutputParam& Param, const FProperty* Property)
+{
+	// Blueprint payloads carry their property, native payloads a check of the type they were made from
+	if (!Property)
+	{
+		return false;
+	}
+	return Param.Property
+		? Param.Property->SameType(Property)
+		: Param.MatchesNativeType && Param.MatchesNativeType(Property) && Param.Size == Property->ElementSize;
+}
+
+void FEventSchema::GetParameters(const UFunction* Function, FParameterList& OutParameters)
+{
+	for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+	{
+		if (It->HasAnyPropertyFlags(CPF_ReturnParm))
+		{
+			break;
+		}
+		OutParameters.Add(*It);
+	}
+}
+
+FEventPayload::FEventPayload(const FEventSchema::FParameterList& InLayout)
+	: Layout(InLayout)
+{
+	for (FProperty* Prop : Layout)
+	{
+		uint8* Value = (uint8*)FMemory::Malloc(Prop->GetSize(), Prop->GetMinAlignment());
+		Prop->InitializeValue(Value);
+
+		FOutputParam& Param = Values.AddDefaulted_GetRef();
+		Param.Property = Prop;
+		Param.PropAddr = Value;
+		Param.Size = Prop->ElementSize;
+	}
+}
+
+FEventPayload::FEventPayload(const FEventSchema::FParameterList& InLayout, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+	: FEventPayload(InLayout)
+{
+	for (int32 Index = 0; Index < Layout.Num(); ++Index)
+	{
+		Layout[Index]->CopyCompleteValue(Values[Index].PropAddr, Params[Index].PropAddr);
+	}
+}
+
+FEventPayload::~FEventPayload()
+{
+	for (int32 Index = 0; Index < Layout.Num(); ++Index)
+	{
+		Layout[Index]->DestroyValue(Values[Index].PropAddr);
+		FMemory::Free(Values[Index].PropAddr);
+	}
+}
+
+void FEventPayload::SerializeValues(FArchive& Ar, const FEventSchema::FParameterList& Layout, const TArray<FOutputParam, TInlineAllocator<8>>& Values)
+{
+	FStructuredArchiveFromArchive StructuredArchive(Ar);
+	FStructuredArchive::FStream Stream = StructuredArchive.GetSlot().EnterStream();
+	for (int32 Index = 0; Index < Layout.Num(); ++Index)
+	{
+		Layout[Index]->SerializeItem(Stream.EnterElement(), Values[Index].PropAddr, nullptr);
+	}
+}
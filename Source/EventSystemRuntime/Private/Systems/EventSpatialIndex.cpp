@@ -0,0 +1,252 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "Systems/EventSpatialIndex.h"
+#include "HAL/IConsoleManager.h"
+
+static float EventSpatialCellSize = 2000.f;
+static FAutoConsoleVariableRef CVarEventSpatialCellSize(TEXT("EventSystem.SpatialCellSize"), EventSpatialCellSize, TEXT("Edge length of the grid cells used by radius notifies, in world units"), ECVF_Default);
+
+void FEventSpatialIndex::Add(const FEventHandle& Handle, USceneComponent* PositionSource)
+{
+	TUniquePtr<FSpatialEvent>& EventPtr = Events.FindOrAdd(Handle.MsgId.ToString());
+	if (!EventPtr.IsValid())
+	{
+		EventPtr = MakeUnique<FSpatialEvent>();
+	}
+	FSpatialEvent& Event = *EventPtr;
+
+	for (auto It = Event.Listeners.CreateIterator(); It; ++It)
+	{
+		if (It->Handle == Handle)
+		{
+			RemoveAt(Event, It.GetIndex());
+			break;
+		}
+	}
+
+	const int32 Index = Event.Listeners.Add(FSpatialListener());
+	FSpatialListener& Listener = Event.Listeners[Index];
+	Listener.Handle = Handle;
+	Listener.PositionSource = PositionSource;
+	Listener.TransformUpdatedHandle = PositionSource->TransformUpdated.AddStatic(&FEventSpatialIndex::OnTransformUpdated, &Event, Index);
+	Event.Moved.Add(Index);
+}
+
+void FEventSpatialIndex::Remove(const FEventHandle& Handle)
+{
+	const FString EventId = Handle.MsgId.ToString();
+	if (TUniquePtr<FSpatialEvent>* Event = Events.Find(EventId))
+	{
+		for (auto It = (*Event)->Listeners.CreateIterator(); It; ++It)
+		{
+			if (It->Handle == Handle)
+			{
+				RemoveAt(**Event, It.GetIndex());
+				break;
+			}
+		}
+
+		if (!(*Event)->Listeners.Num())
+		{
+			Events.Remove(EventId);
+		}
+	}
+}
+
+void FEventSpatialIndex::RemoveListener(const UObject* Listener)
+{
+	RemoveListeners([Listener](const FEventHandle& Handle) { return Handle.Listener.Get() == Listener; });
+}
+
+void FEventSpatialIndex::RemoveListeners(TFunctionRef<bool(const FEventHandle&)> Predicate)
+{
+	for (auto EventIt = Events.CreateIterator(); EventIt; ++EventIt)
+	{
+		FSpatialEvent& Event = *EventIt->Value;
+		for (auto It = Event.Listeners.CreateIterator(); It; ++It)
+		{
+			if (Predicate(It->Handle))
+			{
+				RemoveAt(Event, It.GetIndex());
+			}
+		}
+
+		if (!Event.Listeners.Num())
+		{
+			EventIt.RemoveCurrent();
+		}
+	}
+}
+
+void FEventSpatialIndex::Reset()
+{
+	for (auto& Pair : Events)
+	{
+		for (FSpatialListener& Listener : Pair.Value->Listeners)
+		{
+			if (USceneComponent* PositionSource = Listener.PositionSource.Get())
+			{
+				PositionSource->TransformUpdated.Remove(Listener.TransformUpdatedHandle);
+			}
+		}
+	}
+	Events.Empty();
+}
+
+void FEventSpatialIndex::Query(const FString& EventId, const FVector& Location, float Radius, TArray<FEventHandle>& OutHandles)
+{
+	TUniquePtr<FSpatialEvent>* EventPtr = Events.Find(EventId);
+	if (!EventPtr)
+	{
+		return;
+	}
+	FSpatialEvent& Event = **EventPtr;
+
+	const float CellSize = FMath::Max(EventSpatialCellSize, 1.f);
+	UpdateMoved(Event, CellSize);
+
+	// Listeners that went away without unlistening are dropped as they are found
+	TArray<int32, TInlineAllocator<8>> Invalid;
+	auto Collect = [&](int32 Index, const FSpatialListener& Listener)
+	{
+		if (!Listener.Handle.Listener.IsValid() || !Listener.PositionSource.IsValid())
+		{
+			Invalid.Add(Index);
+		}
+		else if (FVector::DistSquared(Listener.Location, Location) <= Radius * Radius)
+		{
+			OutHandles.Add(Listener.Handle);
+		}
+	};
+
+	const FIntVector MinCell = GetCell(Location - FVector(Radius), CellSize);
+	const FIntVector MaxCell = GetCell(Location + FVector(Radius), CellSize);
+	const int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+
+	// A radius spanning more cells than there are listeners is cheaper to answer by walking the listeners
+	if (NumCells > Event.Listeners.Num())
+	{
+		for (auto It = Event.Listeners.CreateConstIterator(); It; ++It)
+		{
+			Collect(It.GetIndex(), *It);
+		}
+	}
+	else
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					if (const TArray<int32>* Cell = Event.Cells.Find(FIntVector(X, Y, Z)))
+					{
+						for (int32 Index : *Cell)
+						{
+							Collect(Index, Event.Listeners[Index]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (int32 Index : Invalid)
+	{
+		RemoveAt(Event, Index);
+	}
+	if (!Event.Listeners.Num())
+	{
+		Events.Remove(EventId);
+	}
+}
+
+void FEventSpatialIndex::UpdateMoved(FSpatialEvent& Event, float CellSize)
+{
+	if (Event.CellSize != CellSize)
+	{
+		// Every cell changes with the cell size, start over with all listeners
+		Event.CellSize = CellSize;
+		Event.Cells.Reset();
+		Event.Moved.Reset();
+		for (auto It = Event.Listeners.CreateIterator(); It; ++It)
+		{
+			It->bInCell = false;
+			It->bMoved = true;
+			Event.Moved.Add(It.GetIndex());
+		}
+	}
+
+	for (int32 Index : Event.Moved)
+	{
+		if (!Event.Listeners.IsAllocated(Index) || !Event.Listeners[Index].bMoved)
+		{
+			continue;
+		}
+
+		FSpatialListener& Listener = Event.Listeners[Index];
+		USceneComponent* PositionSource = Listener.PositionSource.Get();
+		if (!PositionSource || !Listener.Handle.Listener.IsValid())
+		{
+			RemoveAt(Event, Index);
+			continue;
+		}
+
+		Listener.bMoved = false;
+		Listener.Location = PositionSource->GetComponentLocation();
+		const FIntVector Cell = GetCell(Listener.Location, CellSize);
+		if (Listener.bInCell && Cell == Listener.Cell)
+		{
+			continue;
+		}
+
+		if (Listener.bInCell)
+		{
+			TArray<int32>& OldCell = Event.Cells.FindChecked(Listener.Cell);
+			OldCell.RemoveSingleSwap(Index);
+			if (!OldCell.Num())
+			{
+				Event.Cells.Remove(Listener.Cell);
+			}
+		}
+		Event.Cells.FindOrAdd(Cell).Add(Index);
+		Listener.Cell = Cell;
+		Listener.bInCell = true;
+	}
+	Event.Moved.Reset();
+}
+
+void FEventSpatialIndex::RemoveAt(FSpatialEvent& Event, int32 Index)
+{
+	FSpatialListener& Listener = Event.Listeners[Index];
+	if (USceneComponent* PositionSource = Listener.PositionSource.Get())
+	{
+		PositionSource->TransformUpdated.Remove(Listener.TransformUpdatedHandle);
+	}
+
+	if (Listener.bInCell)
+	{
+		TArray<int32>& Cell = Event.Cells.FindChecked(Listener.Cell);
+		Cell.RemoveSingleSwap(Index);
+		if (!Cell.Num())
+		{
+			Event.Cells.Remove(Listener.Cell);
+		}
+	}
+	Event.Listeners.RemoveAt(Index);
+}
+
+void FEventSpatialIndex::OnTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport, FSpatialEvent* Event, int32 Index)
+{
+	FSpatialListener& Listener = Event->Listeners[Index];
+	if (!Listener.bMoved)
+	{
+		Listener.bMoved = true;
+		Event->Moved.Add(Index);
+	}
+}
+
+FIntVector FEventSpatialIndex::GetCell(const FVector& Location, float CellSize)
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
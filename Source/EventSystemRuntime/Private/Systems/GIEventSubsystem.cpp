@@ -4,16 +4,11 @@
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
+#include "Misc/Paths.h"
+#include "HAL/IConsoleManager.h"
 
 DEFINE_LOG_CATEGORY(EventSystem);
 
-FEventHandle::FEventHandle(UObject* InListener, FName InEventName, FName InMsgID)
-{
-	Listener = TWeakObjectPtr<UObject>(InListener);
-	EventName = InEventName;
-	MsgId = InMsgID;
-}
-
 void UGIEventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
@@ -21,124 +16,85 @@ void UGIEventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 
 void UGIEventSubsystem::Deinitialize()
 {
+	Replayer.Stop();
+	Recorder.Stop();
+	Channel.Reset();
 	Super::Deinitialize();
 }
 
-void UGIEventSubsystem::NotifyEventWithParams(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames)
+UGIEventSubsystem* UGIEventSubsystem::Get(const UObject* WorldContext)
 {
-	if (!ListenerMap.Contains(EventId)) return;
-
-	TArray<FEventHandle> ListenersToRemove;
-
+	if (WorldContext)
 	{
-		TSet<FEventHandle> Listeners = ListenerMap.FindChecked(EventId);
-		for (const auto& Listen : Listeners)
+		const UWorld* const World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+		if (World)
 		{
-			if (!Listen.Listener.Get())
-			{
-				ListenersToRemove.Add(Listen);
-				continue;
-			}
-
-			// FIX (blowpunch)
-			if (Listen.Listener.Get()->IsPendingKillOrUnreachable())
-			{
-				UE_LOG(EventSystem, Warning, TEXT("Listener %s is pending kill or unreachable!"), *Listen.Listener.Get()->GetFName().ToString());
-				continue;
-			}
-			///
-
-			UFunction* Function = Listen.Listener.Get()->FindFunction(Listen.EventName);
-			if (Function)
+			UGIEventSubsystem* System = World->GetGameInstance()->GetSubsystem<UGIEventSubsystem>();
+			if (System)
 			{
-				auto Params = FMemory_Alloca(Function->ParmsSize);
-				FMemory::Memzero(Params, Function->ParmsSize);
-				int32 Index = 0;
-				for (TFieldIterator<FProperty> It(Function); It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
-				{
-					if (It->HasAnyPropertyFlags(CPF_ReturnParm))
-					{
-						break;
-					}
-					FProperty* Prop = *It;
-
-					Prop->CopyCompleteValue(Prop->ContainerPtrToValuePtr<void>(Params), Outparames[Index].PropAddr);
-					++Index;
-				}
-				Listen.Listener.Get()->ProcessEvent(Function, Params);
+				return System;
 			}
 		}
 	}
+	return nullptr;
+}
 
-	if (ListenersToRemove.Num())
-	{
-		TSet<FEventHandle>& Listeners = ListenerMap.FindChecked(EventId);
-		for (const auto& ListenerToRemove : ListenersToRemove)
-		{
-			Listeners.Remove(ListenerToRemove);
-		}
+FString UGIEventSubsystem::GetEventLogPath(const FString& Filename)
+{
+	return FPaths::IsRelative(Filename) ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("EventLogs"), Filename) : Filename;
+}
 
-		if (!Listeners.Num()) ListenerMap.Remove(EventId);
-		UE_LOG(EventSystem, Log, TEXT("Removed invalid listeners."));
-	}
+bool UGIEventSubsystem::StartRecording(const FString& Filename)
+{
+	return Recorder.Start(Channel, GetEventLogPath(Filename));
 }
 
-const FEventHandle UGIEventSubsystem::ListenEvent(const FString& MessageId, UObject* Listener, FName EventName)
+bool UGIEventSubsystem::StartReplay(const FString& Filename, float PlaybackRate)
 {
-	FName MsgID = FName (*MessageId);
-	FEventHandle Lis(Listener, EventName, MsgID);
-	TSet<FEventHandle>& Listeners = ListenerMap.FindOrAdd(MessageId);
-	if (!Listeners.Contains(Lis))
-	{
-		Listeners.Add(Lis);
-	}
-	return Lis;
+	return Replayer.Start(Channel, GetEventLogPath(Filename), PlaybackRate);
 }
 
-void UGIEventSubsystem::UnListenEvent(const FEventHandle& InHandle)
+static void EventRecord(const TArray<FString>& Args, UWorld* World)
 {
-	FString MsgID = InHandle.MsgId.ToString();
-	if (ListenerMap.Contains(MsgID))
+	UGIEventSubsystem* System = UGIEventSubsystem::Get(World);
+	if (System)
 	{
-		TSet<FEventHandle>& Listeners = ListenerMap.FindChecked(MsgID);
-		Listeners.Remove(InHandle);
-		if (Listeners.Num() == 0)
-		{
-			ListenerMap.Remove(MsgID);
-		}
+		System->StartRecording(Args.Num() ? Args[0] : TEXT("Events.evlog"));
 	}
 }
 
-// FIX (blowpunch)
-void UGIEventSubsystem::UnListenEvents(UObject* Listener)
+static void EventStopRecording(const TArray<FString>& Args, UWorld* World)
 {
-	for (auto It = ListenerMap.CreateConstIterator(); It; ++It)
+	UGIEventSubsystem* System = UGIEventSubsystem::Get(World);
+	if (System)
 	{
-		auto Listeners = *It;
-		for (auto SubIt = Listeners.Value.CreateConstIterator(); SubIt; ++SubIt)
-		{
-			FEventHandle Listen = *SubIt;
-			if (Listen.Listener.Get() == Listener) Listeners.Value.Remove(Listen);
-		}
-
-		if (Listeners.Value.Num() == 0) ListenerMap.Remove(Listeners.Key);
+		System->StopRecording();
 	}
 }
-///
 
-UGIEventSubsystem* UGIEventSubsystem::Get(const UObject* WorldContext)
+static void EventReplay(const TArray<FString>& Args, UWorld* World)
 {
-	if (WorldContext)
+	UGIEventSubsystem* System = UGIEventSubsystem::Get(World);
+	if (System)
 	{
-		const UWorld* const World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
-		if (World)
-		{
-			UGIEventSubsystem* System = World->GetGameInstance()->GetSubsystem<UGIEventSubsystem>();
-			if (System)
-			{
-				return System;
-			}
-		}
+		System->StartReplay(Args.Num() ? Args[0] : TEXT("Events.evlog"), Args.Num() > 1 ? FCString::Atof(*Args[1]) : 1.f);
 	}
-	return nullptr;
 }
+
+FAutoConsoleCommandWithWorldAndArgs EventRecordCmd(
+	TEXT("EventSystem.Record"),
+	TEXT("Records every notify to a log in Saved/EventLogs. Usage: EventSystem.Record [File]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(EventRecord)
+);
+
+FAutoConsoleCommandWithWorldAndArgs EventStopRecordingCmd(
+	TEXT("EventSystem.StopRecording"),
+	TEXT("Stops recording notifies"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(EventStopRecording)
+);
+
+FAutoConsoleCommandWithWorldAndArgs EventReplayCmd(
+	TEXT("EventSystem.Replay"),
+	TEXT("Replays a recorded event log. Usage: EventSystem.Replay [File] [PlaybackRate, 0 replays everything at once]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(EventReplay)
+);
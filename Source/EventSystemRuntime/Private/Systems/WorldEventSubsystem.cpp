@@ -0,0 +1,123 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "Systems/WorldEventSubsystem.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+
+void UWorldEventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UWorldEventSubsystem::OnLevelRemovedFromWorld);
+}
+
+void UWorldEventSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	LevelChannels.Empty();
+	SpatialIndex.Reset();
+	WorldChannel.Reset();
+	Super::Deinitialize();
+}
+
+UWorldEventSubsystem* UWorldEventSubsystem::Get(const UObject* WorldContext)
+{
+	if (WorldContext)
+	{
+		const UWorld* const World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+		if (World)
+		{
+			return World->GetSubsystem<UWorldEventSubsystem>();
+		}
+	}
+	return nullptr;
+}
+
+FEventChannel* UWorldEventSubsystem::FindLevelChannel(const ULevel* Level)
+{
+	TUniquePtr<FEventChannel>* Channel = LevelChannels.Find(Level);
+	return Channel ? Channel->Get() : nullptr;
+}
+
+FEventChannel& UWorldEventSubsystem::FindOrAddLevelChannel(const ULevel* Level)
+{
+	TUniquePtr<FEventChannel>& Channel = LevelChannels.FindOrAdd(Level);
+	if (!Channel.IsValid())
+	{
+		Channel = MakeUnique<FEventChannel>(EEventScope::Level);
+	}
+	return *Channel;
+}
+
+ULevel* UWorldEventSubsystem::GetLevelOf(const UObject* Object) const
+{
+	ULevel* Level = Object ? Object->GetTypedOuter<ULevel>() : nullptr;
+	return Level ? Level : GetWorld()->PersistentLevel;
+}
+
+FEventHandle UWorldEventSubsystem::ListenEventSpatial(const FString& EventId, UObject* Listener, FName EventName, USceneComponent* PositionSource)
+{
+	if (!PositionSource)
+	{
+		AActor* Actor = Cast<AActor>(Listener);
+		Actor = Actor ? Actor : (Listener ? Listener->GetTypedOuter<AActor>() : nullptr);
+		PositionSource = Actor ? Actor->GetRootComponent() : nullptr;
+	}
+
+	FEventHandle Handle = WorldChannel.ListenEvent(EventId, Listener, EventName);
+	if (Handle.Listener.IsValid() && PositionSource)
+	{
+		SpatialIndex.Add(Handle, PositionSource);
+	}
+	return Handle;
+}
+
+void UWorldEventSubsystem::UnListenEvent(const FEventHandle& Handle)
+{
+	SpatialIndex.Remove(Handle);
+	WorldChannel.UnListenEvent(Handle);
+}
+
+void UWorldEventSubsystem::UnListenEvents(UObject* Listener)
+{
+	SpatialIndex.RemoveListener(Listener);
+	WorldChannel.UnListenEvents(Listener);
+}
+
+void UWorldEventSubsystem::NotifyEventInRadiusWithParams(const FString& EventId, UObject* Sender, const FVector& Location, float Radius, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	check(IsInGameThread());
+
+	TArray<FEventHandle> Targets;
+	SpatialIndex.Query(EventId, Location, Radius, Targets);
+	if (Targets.Num())
+	{
+		WorldChannel.NotifyEventToListeners(EventId, Sender, Params, Targets);
+	}
+}
+
+void UWorldEventSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// A null level means every level of the world is going away
+	if (Level)
+	{
+		LevelChannels.Remove(Level);
+		SpatialIndex.RemoveListeners([Level](const FEventHandle& Handle)
+		{
+			const UObject* Listener = Handle.Listener.Get();
+			return !Listener || Listener->IsIn(Level);
+		});
+	}
+	else
+	{
+		LevelChannels.Empty();
+		SpatialIndex.Reset();
+	}
+}
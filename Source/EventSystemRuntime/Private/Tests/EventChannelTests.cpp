@@ -0,0 +1,105 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Systems/EventChannel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEventChannelCrossThreadNotifyTest, "EventSystem.Channel.CrossThreadNotify", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Notifies from every worker at once while the game thread drains the deferred payloads.
+ * Meant to be run under a thread sanitizer, payloads are created on workers and released on the game thread.
+ */
+bool FEventChannelCrossThreadNotifyTest::RunTest(const FString& Parameters)
+{
+	static const TCHAR* EventId = TEXT("EventSystem.Test.CrossThreadNotify");
+	static const int32 NumNotifies = 8192;
+
+	// Off-thread notifies copy their payload with the declared layout, declare a single int
+	const FOnResolveEventParameters PreviousResolve = FEventChannel::ResolveEventParameters;
+	FEventChannel::ResolveEventParameters.BindLambda([PreviousResolve](FName InEventId, TArray<FEventParameterDesc>& OutParameters, FEventThrottle& OutThrottle)
+	{
+		if (InEventId == FName(EventId))
+		{
+			OutParameters.Add({ FName(TEXT("Value")), TEXT("{\"PinCategory\":\"int\"}") });
+			return true;
+		}
+		return PreviousResolve.IsBound() && PreviousResolve.Execute(InEventId, OutParameters, OutThrottle);
+	});
+
+	int32 GameThreadCount = 0;
+	int64 GameThreadSum = 0;
+	TAtomic<int32> AnyThreadCount(0);
+	TAtomic<int32> WrongThreadCount(0);
+	{
+		FEventChannel Channel;
+		Channel.ListenEventNative(EventId, FOnEventNotified::CreateLambda([&GameThreadCount, &GameThreadSum, &WrongThreadCount](const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+		{
+			if (!IsInGameThread())
+			{
+				++WrongThreadCount;
+			}
+			GameThreadSum += *(const int32*)Params[0].PropAddr;
+			++GameThreadCount;
+		}));
+		Channel.ListenEventNative(EventId, FOnEventNotified::CreateLambda([&AnyThreadCount](const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+		{
+			++AnyThreadCount;
+		}), nullptr, true);
+
+		ParallelFor(NumNotifies, [&Channel](int32 Index)
+		{
+			int32 Value = Index;
+			Channel.NotifyEvent(EventId, nullptr, Value);
+		});
+
+		// Deferred deliveries reference the locals above, drain every one of them before leaving the scope
+		const double Deadline = FPlatformTime::Seconds() + 30.0;
+		while (GameThreadCount < NumNotifies && FPlatformTime::Seconds() < Deadline)
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		}
+	}
+
+	FEventChannel::ResolveEventParameters = PreviousResolve;
+
+	TestEqual(TEXT("Every notify reached the game thread listener"), GameThreadCount, NumNotifies);
+	TestEqual(TEXT("Every payload arrived intact"), GameThreadSum, (int64)NumNotifies * (NumNotifies - 1) / 2);
+	TestEqual(TEXT("Every notify reached the any thread listener"), AnyThreadCount.Load(), NumNotifies);
+	TestEqual(TEXT("Game thread listeners only ran on the game thread"), WrongThreadCount.Load(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEventChannelKeyedNotifyTest, "EventSystem.Channel.KeyedNotify", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/** Keys and ids address the same listeners, and ids keep comparing case insensitively */
+bool FEventChannelKeyedNotifyTest::RunTest(const FString& Parameters)
+{
+	const FEventKey Key = FEventKey::FindOrAdd(TEXT("EventSystem.Test.KeyedNotify"));
+	TestTrue(TEXT("Registered key is valid"), Key.IsValid());
+	TestEqual(TEXT("Ids are case insensitive"), FEventKey::Find(TEXT("eventsystem.test.keyednotify")).GetId(), Key.GetId());
+	TestEqual(TEXT("Key keeps its id"), Key.GetEventId(), FString(TEXT("EventSystem.Test.KeyedNotify")));
+	TestFalse(TEXT("Unknown ids have no key"), FEventKey::Find(TEXT("EventSystem.Test.NeverRegistered")).IsValid());
+
+	int32 Count = 0;
+	FEventChannel Channel;
+	const FDelegateHandle Handle = Channel.ListenEventNative(TEXT("EventSystem.Test.KeyedNotify"), FOnEventNotified::CreateLambda([&Count](const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+	{
+		++Count;
+	}));
+
+	Channel.NotifyEventWithParams(Key, nullptr, {});
+	Channel.NotifyEventWithParams(TEXT("EventSystem.Test.KeyedNotify"), nullptr, {});
+	TestEqual(TEXT("Keyed and string notifies reach the same listener"), Count, 2);
+
+	Channel.UnListenEventNative(Key, Handle);
+	Channel.NotifyEventWithParams(Key, nullptr, {});
+	TestEqual(TEXT("Unlistening by key removes the listener"), Count, 2);
+	return true;
+}
+
+#endif
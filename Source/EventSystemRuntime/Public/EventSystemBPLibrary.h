@@ -12,15 +12,25 @@ class EVENTSYSTEMRUNTIME_API UEventSystemBPLibrary : public UBlueprintFunctionLi
 	GENERATED_UCLASS_BODY()
 
 public:
-	static void NotifyEventByKey(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames);
+	static void NotifyEventByKey(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames, EEventScope Scope = EEventScope::GameInstance);
+
+	/** Channel of Scope as seen from Context, level channels are created on demand when bCreate is set */
+	static FEventChannel* GetChannel(EEventScope Scope, const UObject* Context, bool bCreate = true);
 public:
 	UFUNCTION(BlueprintCallable, CustomThunk, meta = (CallableWithoutWorldContext, BlueprintInternalUseOnly = true, HidePin = "Sender", DefaultToSelf = "Sender", AutoCreateRefTerm = "MessageId", Variadic), Category = "EventSystem")
 	static void NotifyEventByKeyVariadic(const FString& MessageId, UObject* Sender); 
 	DECLARE_FUNCTION(execNotifyEventByKeyVariadic);
 
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (CallableWithoutWorldContext, BlueprintInternalUseOnly = true, HidePin = "Sender", DefaultToSelf = "Sender", AutoCreateRefTerm = "MessageId", Variadic), Category = "EventSystem")
+	static void NotifyEventByKeyVariadicInScope(const FString& MessageId, UObject* Sender, EEventScope Scope);
+	DECLARE_FUNCTION(execNotifyEventByKeyVariadicInScope);
+
 	UFUNCTION(BlueprintCallable, meta = (CallableWithoutWorldContext, BlueprintInternalUseOnly = true, HidePin = "Listener", DefaultToSelf = "Listener", AutoCreateRefTerm = "MessageId", Variadic), Category = "EventSystem")
 	static FEventHandle ListenEventByKey(const FString& MessageId, UObject* Listener, FName EventName);
 
+	UFUNCTION(BlueprintCallable, meta = (CallableWithoutWorldContext, BlueprintInternalUseOnly = true, HidePin = "Listener", DefaultToSelf = "Listener", AutoCreateRefTerm = "MessageId"), Category = "EventSystem")
+	static FEventHandle ListenEventByKeyInScope(const FString& MessageId, UObject* Listener, FName EventName, EEventScope Scope);
+
 	UFUNCTION(BlueprintCallable, Category = "EventSystem", meta = (HidePin = "WorldContext", DefaultToSelf = "WorldContext"))
 	static void UnListenEvent(const UObject* WorldContext, const FEventHandle& Handle);
 
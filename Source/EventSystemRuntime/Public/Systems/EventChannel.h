@@ -0,0 +1,319 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Systems/EventSchema.h"
+#include "Systems/EventKey.h"
+#include <tuple>
+#include "EventChannel.generated.h"
+
+/**
+ * Fills the dictionary declaration of an event, returns false if the dictionary doesn't know the event.
+ * Empty OutParameters leave the parameters undeclared, the first listener then defines them.
+ */
+DECLARE_DELEGATE_RetVal_ThreeParams(bool, FOnResolveEventParameters, FName /*EventId*/, TArray<FEventParameterDesc>& /*OutParameters*/, FEventThrottle& /*OutThrottle*/);
+
+/** Which listeners a notify reaches */
+UENUM(BlueprintType)
+enum class EEventScope : uint8
+{
+	/** Every listener of the game instance, survives world changes */
+	GameInstance,
+	/** Listeners of one world, torn down with it */
+	World,
+	/** Listeners of the sender's level, torn down when the level streams out */
+	Level,
+};
+
+USTRUCT(BlueprintType)
+struct FEventHandle
+{
+	GENERATED_USTRUCT_BODY();
+public:
+	FEventHandle() :
+		Listener(nullptr),
+		EventName(TEXT("")),
+		MsgId(TEXT("")),
+		Scope(EEventScope::GameInstance)
+	{};
+
+	FEventHandle(UObject* InListener, FName InEventName, FName InMsgID, EEventScope InScope = EEventScope::GameInstance);
+
+	friend bool operator==(const FEventHandle& Lhs, const FEventHandle& Rhs)
+	{
+		return Lhs.EventName == Rhs.EventName 
+			&& Lhs.Listener.Get() == Rhs.Listener.Get() && Lhs.MsgId == Rhs.MsgId;
+	}
+
+	friend bool operator!=(const FEventHandle& Lhs, const FEventHandle& Rhs)
+	{
+		return Lhs.EventName != Rhs.EventName
+			|| Lhs.Listener.Get() != Rhs.Listener.Get() || Lhs.MsgId != Rhs.MsgId;
+	}
+	friend uint32 GetTypeHash(const FEventHandle& Handle)
+	{
+		return (GetTypeHash(Handle.MsgId) + 12 * GetTypeHash(Handle.Listener.Get()) + 23 * GetTypeHash(Handle.EventName));
+	}
+
+	FORCEINLINE FString ToString() const
+	{
+		FString ListenerName = Listener.Get() && Listener.Get()->IsValidLowLevel() ? Listener.Get()->GetName() : TEXT("");
+		return FString::Printf(TEXT("MsgID : %s; EventName: %s; Listener : %s"),*MsgId.ToString(),*EventName.ToString(), *ListenerName);
+	}
+	FName GetMsgId() { return MsgId; }
+public:
+	TWeakObjectPtr<UObject> Listener;
+	FName EventName;
+	FName MsgId;
+
+	/** Channel the listener was registered in, not part of the handle identity */
+	EEventScope Scope;
+};
+
+/** Instances of one class listening to an event through the same function, the function and its parameters are resolved once */
+struct FEventClassListeners
+{
+	TWeakObjectPtr<UClass> Class;
+	FName EventName;
+	TWeakObjectPtr<UFunction> Function;
+
+	/** Input parameters of Function, payload values are copied into these in order */
+	FEventSchema::FParameterList Parameters;
+	FProperty* ReturnProperty = nullptr;
+
+	TArray<TWeakObjectPtr<UObject>> Instances;
+};
+
+/** Native callback, payload values are at Params[i].PropAddr in the order of the event parameters */
+DECLARE_DELEGATE_OneParam(FOnEventNotified, const TArray<FOutputParam, TInlineAllocator<8>>& /*Params*/);
+
+/** Called for every notify that reaches listeners, Layout describes the payload and is the declared one when the dictionary has it */
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnEventChannelNotify, const FString& /*EventId*/, UObject* /*Sender*/, const TArray<FOutputParam, TInlineAllocator<8>>& /*Params*/, const FEventSchema::FParameterList& /*Layout*/);
+
+/** A native callback listening to an event */
+struct FEventNativeListener
+{
+	FDelegateHandle Handle;
+	FOnEventNotified Callback;
+
+	/** Listener is dropped once its owner is collected, listeners without owner stay until unlistened */
+	TWeakObjectPtr<const UObject> Owner;
+	bool bHasOwner = false;
+
+	/** Callback may run on any thread, in parallel with the other AnyThread listeners of the event */
+	bool bAnyThread = false;
+
+	bool IsValid() const { return !bHasOwner || Owner.IsValid(); }
+};
+
+/** Immutable copy of the listeners of one event, notifies dispatch from it without holding the shard lock */
+struct FEventListenerSnapshot
+{
+	TArray<FEventClassListeners> Classes;
+	TArray<FEventNativeListener> NativeListeners;
+
+	/** Some listener has to run on the game thread */
+	bool bHasGameThreadListeners = false;
+};
+
+typedef TSharedPtr<const FEventListenerSnapshot, ESPMode::ThreadSafe> FEventListenerSnapshotPtr;
+
+/** All listeners of one event, grouped by class so dispatch walks contiguous instance arrays */
+struct FEventListeners
+{
+	TArray<FEventClassListeners> Classes;
+
+	/** Registered handles, keeps Listen idempotent without scanning the instance arrays */
+	TSet<FEventHandle> Handles;
+
+	TArray<FEventNativeListener> NativeListeners;
+
+	FEventClassListeners* FindClass(const UClass* Class, FName EventName);
+
+	bool IsEmpty() const { return Handles.Num() == 0 && NativeListeners.Num() == 0; }
+
+	/** Returns the snapshot of Classes and NativeListeners, rebuilt on the first notify after a change. Shard must be locked */
+	const FEventListenerSnapshotPtr& GetSnapshot();
+
+	/** Must be called after every change of Classes or NativeListeners. Shard must be locked */
+	void InvalidateSnapshot() { Snapshot.Reset(); }
+
+private:
+	FEventListenerSnapshotPtr Snapshot;
+};
+
+/**
+ * A set of listeners notified together.
+ * The game instance, every world and every streamed level own one, a notify only considers the listeners of its channel.
+ * Listen, UnListen and Notify may be called from any thread. Listeners always run on the game thread,
+ * a notify from another thread copies its payload and is delivered on the next game thread tick.
+ */
+class EVENTSYSTEMRUNTIME_API FEventChannel
+{
+public:
+	explicit FEventChannel(EEventScope InScope = EEventScope::GameInstance);
+	~FEventChannel();
+	FEventChannel(const FEventChannel&) = delete;
+	FEventChannel& operator=(const FEventChannel&) = delete;
+
+	void NotifyEventWithParams(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames);
+	const FEventHandle ListenEvent(const FString& MessageId, UObject* Listener, FName EventName);
+	void UnListenEvent(const FEventHandle& InHandle);
+	void UnListenEvents(UObject* Listener);
+
+	/** Notifies only Targets, each of which must have been returned by ListenEvent of this channel. Game thread only */
+	void NotifyEventToListeners(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames, const TArray<FEventHandle>& Targets);
+
+	/**
+	 * Registers a native callback on EventId.
+	 * AnyThread callbacks must only touch thread safe data, large fan-outs of them are dispatched with ParallelFor
+	 * and the notify waits for all of them before returning.
+	 */
+	FDelegateHandle ListenEventNative(const FString& EventId, FOnEventNotified Callback, const UObject* Owner = nullptr, bool bAnyThread = false);
+	void UnListenEventNative(const FString& EventId, FDelegateHandle Handle);
+
+	template<typename... TArgs>
+	void NotifyEvent(const FString& EventId, UObject* Sender, TArgs&&... Args);
+
+	/** Indexed overloads, for callers that looked the key of their event up once. They skip hashing the id on every call */
+	void NotifyEventWithParams(FEventKey Key, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames);
+	FDelegateHandle ListenEventNative(FEventKey Key, FOnEventNotified Callback, const UObject* Owner = nullptr, bool bAnyThread = false);
+	void UnListenEventNative(FEventKey Key, FDelegateHandle Handle);
+
+	template<typename... TArgs>
+	void NotifyEvent(FEventKey Key, UObject* Sender, TArgs&&... Args);
+
+	/** Drops every listener and cached schema */
+	void Reset();
+
+	/** Copies the payload layout of EventId, false if neither a listener nor the dictionary describes it yet */
+	bool GetLayout(const FString& EventId, FEventSchema::FParameterList& OutLayout);
+
+	/**
+	 * Copies the layout made from the dictionary declaration of EventId, false if it declares no parameters or a type
+	 * without runtime property. Unlike GetLayout it doesn't depend on who listens here, so both ends of a connection agree
+	 */
+	bool GetDeclaredLayout(const FString& EventId, FEventSchema::FParameterList& OutLayout);
+
+	/** Observes every notify, the observer runs on the notifying thread with the shard of the event locked and must not call back into the channel */
+	FDelegateHandle AddOnNotify(FOnEventChannelNotify::FDelegate Observer);
+	void RemoveOnNotify(FDelegateHandle Handle);
+
+	/** Bound by the events dictionary so listeners can be checked against the declared parameters */
+	static FOnResolveEventParameters ResolveEventParameters;
+
+private:
+	/** Events are spread over shards by key, each shard has its own lock */
+	static constexpr int32 NumShards = 16;
+
+	struct FShard
+	{
+		FCriticalSection Lock;
+		TMap<FEventKey, FEventListeners> ListenerMap;
+
+		/** Schemas outlive their listeners so a later listener is still checked against the first one */
+		TMap<FEventKey, FEventSchema> Schemas;
+
+		/** Only events with an active throttle have an entry */
+		TMap<FEventKey, FEventThrottleState> Throttles;
+	};
+
+	FShard& GetShard(FEventKey Key) { return Shards[Key.GetId() % NumShards]; }
+
+	/** Returns the schema of Key, pulling its declaration from the dictionary the first time. Shard must be locked */
+	static FEventSchema& FindOrAddSchema(FShard& Shard, FEventKey Key);
+
+	/** Validates and throttles a notify and reports it to OnNotify, returns false if it must be dropped. Shard must be locked */
+	bool PrepareNotify(FShard& Shard, FEventKey Key, const FEventListeners& Listeners, FEventSchema& Schema, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	/** Runs every listener of Classes with Params, returns true if some listener is gone */
+	static bool DispatchToListeners(const TArray<FEventClassListeners>& Classes, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	/** Runs the function of ClassListeners on Instances, returns true if some listener is gone */
+	static bool DispatchToClass(const FEventClassListeners& ClassListeners, TArrayView<const TWeakObjectPtr<UObject>> Instances, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	/** Runs the native listeners matching bAnyThread, returns true if some listener is gone */
+	static bool DispatchToNativeListeners(const TArray<FEventNativeListener>& NativeListeners, const TArray<FOutputParam, TInlineAllocator<8>>& Params, bool bAnyThread);
+
+	/**
+	 * Applies the throttle of Schema to a notify, returns false if the notify must not reach the listeners now.
+	 * Suppressed payloads are kept for trailing delivery when the throttle asks for it. Shard must be locked
+	 */
+	bool PassThrottle(FShard& Shard, FEventKey Key, const FEventSchema& Schema, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	/** Makes sure FlushTrailingNotifies ticks on the game thread */
+	void ScheduleTrailingFlush();
+
+	/** Delivers the pending trailing notifies whose throttle allows it, ticks until none is left */
+	bool FlushTrailingNotifies(float DeltaTime);
+
+	/** Drops listeners and classes that were collected. Shard must be locked */
+	void RemoveInvalidListeners(FShard& Shard, FEventKey Key);
+
+	/** Logs Message once per Key for the lifetime of the channel */
+	void ReportMismatchOnce(const FString& Key, const FString& Message);
+
+	/** Drops Handle from Listeners, returns true if it was registered */
+	static bool RemoveListener(FEventListeners& Listeners, const FEventHandle& Handle);
+
+	FShard Shards[NumShards];
+
+	/** Notifies broadcast from any thread while observers come and go, the delegate has its own lock */
+	FCriticalSection OnNotifyLock;
+	FOnEventChannelNotify OnNotify;
+
+	FCriticalSection ReportedMismatchesLock;
+	TSet<FString> ReportedMismatches;
+
+	/** Game thread ticker delivering trailing notifies, only registered while some are pending */
+	FDelegateHandle TrailingFlushHandle;
+
+	/** Cleared when the channel dies, lets tasks queued from other threads know it is gone */
+	TSharedRef<FEventChannel*, ESPMode::ThreadSafe> SelfToken;
+
+	EEventScope Scope;
+};
+
+template<typename T>
+FOutputParam MakeOutputParam(T& t)
+{
+	FOutputParam OutputParam;
+	OutputParam.PropAddr = (uint8*)std::addressof(t);
+	OutputParam.Size = sizeof(T);
+	OutputParam.MatchesNativeType = &TEventNativeType<typename TRemoveCV<T>::Type>::Matches;
+	return OutputParam;
+}
+
+template<typename T,size_t... Is>
+TArray<FOutputParam, TInlineAllocator<8>> MakeOutputParamFromTuple(T& Tuple, const std::index_sequence<Is...>&)
+{
+	return TArray<FOutputParam, TInlineAllocator<8>>{MakeOutputParam(std::get<Is>(Tuple))...};
+}
+
+template<typename T>
+TArray<FOutputParam, TInlineAllocator<8>> MakeParam(T& tup)
+{
+	return MakeOutputParamFromTuple(tup, std::make_index_sequence<std::tuple_size<T>::value>());
+}
+
+
+template<typename... TArgs>
+void FEventChannel::NotifyEvent(const FString& EventId, UObject* Sender, TArgs&&... Args)
+{
+	//暂时注释看看下边支持情况不行在改回来
+	//std::tuple<TArgs...> InParams(std::forward<TArgs>(Args)...);
+	//TArray<FOutputParam, TInlineAllocator<8>> OutputParam = MakeParam(InParams);
+
+	// c++14 支持
+	TArray<FOutputParam, TInlineAllocator<8>> VOutputParam = { MakeOutputParam(Args)... };
+
+	this->NotifyEventWithParams(EventId, Sender, VOutputParam);
+}
+
+template<typename... TArgs>
+void FEventChannel::NotifyEvent(FEventKey Key, UObject* Sender, TArgs&&... Args)
+{
+	TArray<FOutputParam, TInlineAllocator<8>> VOutputParam = { MakeOutputParam(Args)... };
+	this->NotifyEventWithParams(Key, Sender, VOutputParam);
+}
@@ -0,0 +1,40 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Integer handle of an event id, shared by every channel. Ids are registered once and never removed, so a key can be
+ * looked up once, by generated code or the events dictionary, and notifies made with it never hash the id again.
+ * Ids compare case insensitively, like the FString keys they replace.
+ */
+struct EVENTSYSTEMRUNTIME_API FEventKey
+{
+	FEventKey() {}
+
+	/** Key of EventId, registered on first use. Any thread */
+	static FEventKey FindOrAdd(const FString& EventId);
+
+	/** Key of EventId, invalid if it was never registered. Any thread */
+	static FEventKey Find(const FString& EventId);
+
+	FORCEINLINE bool IsValid() const { return Id != INDEX_NONE; }
+	FORCEINLINE int32 GetId() const { return Id; }
+
+	/** The id the key was registered with, stays valid for the lifetime of the process */
+	const FString& GetEventId() const;
+
+	FORCEINLINE bool operator==(const FEventKey& Other) const { return Id == Other.Id; }
+	FORCEINLINE bool operator!=(const FEventKey& Other) const { return Id != Other.Id; }
+
+	FORCEINLINE friend uint32 GetTypeHash(const FEventKey& Key)
+	{
+		return (uint32)Key.Id;
+	}
+
+private:
+	explicit FEventKey(int32 InId) : Id(InId) {}
+
+	int32 Id = INDEX_NONE;
+};
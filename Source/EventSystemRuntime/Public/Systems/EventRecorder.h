@@ -0,0 +1,89 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Systems/EventChannel.h"
+#include "Containers/Ticker.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Appends every notify of a channel to a binary log.
+ * Each recording starts a session record, each notify entry holds the time since its session started, the event id,
+ * the sender path and the payload serialized with the event layout.
+ */
+class EVENTSYSTEMRUNTIME_API FEventRecorder
+{
+public:
+	~FEventRecorder();
+
+	/** Starts appending the notifies of Channel to Filename, returns false if the file can't be written */
+	bool Start(FEventChannel& InChannel, const FString& Filename);
+	void Stop();
+
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	static const uint32 FileMagic;
+	static const uint32 FileVersion;
+
+	/** Tags the records of a log */
+	enum class ERecordType : uint8
+	{
+		Session,
+		Notify,
+	};
+
+private:
+	void OnNotify(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params, const FEventSchema::FParameterList& Layout);
+
+	FCriticalSection WriterLock;
+	TUniquePtr<FArchive> Writer;
+	double StartTime = 0.0;
+
+	FEventChannel* Channel = nullptr;
+	FDelegateHandle NotifyHandle;
+};
+
+/**
+ * Feeds a log written by FEventRecorder back through a channel.
+ * The log is memory mapped and read entry by entry, at the recorded pace scaled by a playback rate or all at once.
+ */
+class EVENTSYSTEMRUNTIME_API FEventReplayer
+{
+public:
+	~FEventReplayer();
+
+	/**
+	 * Starts replaying Filename into InChannel.
+	 * @param PlaybackRate	Speed relative to the recording, 0 or less replays the whole log immediately
+	 */
+	bool Start(FEventChannel& InChannel, const FString& Filename, float PlaybackRate = 1.f);
+	void Stop();
+
+	bool IsReplaying() const { return MappedRegion.IsValid(); }
+
+private:
+	bool Tick(float DeltaTime);
+
+	/** Dispatches every entry recorded before Time, returns false once the log is exhausted */
+	bool ReplayUntil(double Time);
+
+	/** Replay time at which the current session started, sessions are replayed back to back */
+	double SessionStart = 0.0;
+
+	/** Replay time of the last dispatched entry */
+	double LastEntryTime = 0.0;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TUniquePtr<FArchive> Reader;
+
+	double ReplayTime = 0.0;
+	float Rate = 1.f;
+	int32 NumSkipped = 0;
+
+	FEventChannel* Channel = nullptr;
+	FDelegateHandle TickHandle;
+};
@@ -0,0 +1,375 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EdGraph/EdGraphPin.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/SoftObjectPtr.h"
+#include "UObject/ScriptInterface.h"
+#include "EventSchema.generated.h"
+
+/** Checks that a property holds values of the native type a payload parameter was made from */
+typedef bool (*FEventNativeTypeMatcher)(const FProperty* Property);
+
+struct FOutputParam
+{
+	FProperty* Property = nullptr;
+	uint8* PropAddr = nullptr;
+
+	/** Size of the value at PropAddr */
+	int32 Size = 0;
+
+	/** Type check of native payloads that carry no property, see TEventNativeType */
+	FEventNativeTypeMatcher MatchesNativeType = nullptr;
+};
+
+/**
+ * Maps the native type of a payload parameter to the properties that can receive it, so native notifies are
+ * checked as strictly as blueprint ones. Types without a specialization can't be checked and are rejected.
+ */
+template<typename T, typename Enable = void>
+struct TEventNativeType
+{
+	static bool Matches(const FProperty* Property) { return false; }
+};
+
+#define EVENT_NATIVE_TYPE(Type, PropertyType) \
+	template<> struct TEventNativeType<Type> { static bool Matches(const FProperty* Property) { return Property && Property->IsA<PropertyType>(); } };
+
+EVENT_NATIVE_TYPE(int8, FInt8Property)
+EVENT_NATIVE_TYPE(int16, FInt16Property)
+EVENT_NATIVE_TYPE(int32, FIntProperty)
+EVENT_NATIVE_TYPE(int64, FInt64Property)
+EVENT_NATIVE_TYPE(uint8, FByteProperty)
+EVENT_NATIVE_TYPE(uint16, FUInt16Property)
+EVENT_NATIVE_TYPE(uint32, FUInt32Property)
+EVENT_NATIVE_TYPE(uint64, FUInt64Property)
+EVENT_NATIVE_TYPE(float, FFloatProperty)
+EVENT_NATIVE_TYPE(double, FDoubleProperty)
+EVENT_NATIVE_TYPE(FName, FNameProperty)
+EVENT_NATIVE_TYPE(FString, FStrProperty)
+EVENT_NATIVE_TYPE(FText, FTextProperty)
+
+#undef EVENT_NATIVE_TYPE
+
+template<>
+struct TEventNativeType<bool>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FBoolProperty* BoolProperty = CastField<const FBoolProperty>(Property);
+		return BoolProperty && BoolProperty->IsNativeBool();
+	}
+};
+
+/** Enums without reflection can't name their UEnum, the storage has to be an enum of the same size */
+template<typename T>
+struct TEventNativeType<T, typename TEnableIf<TIsEnum<T>::Value>::Type>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FByteProperty* ByteProperty = CastField<const FByteProperty>(Property);
+		return Property && Property->ElementSize == sizeof(T) && (Property->IsA<FEnumProperty>() || (ByteProperty && ByteProperty->Enum));
+	}
+};
+
+template<typename T>
+struct TEventNativeType<TEnumAsByte<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FByteProperty* ByteProperty = CastField<const FByteProperty>(Property);
+		return ByteProperty && ByteProperty->Enum;
+	}
+};
+
+/** The listener must accept any object of the sent type */
+template<typename T>
+struct TEventNativeType<T*, typename TEnableIf<TIsDerivedFrom<T, UObject>::IsDerived>::Type>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FObjectProperty* ObjectProperty = CastField<const FObjectProperty>(Property);
+		return ObjectProperty && !Property->IsA<FClassProperty>() && T::StaticClass()->IsChildOf(ObjectProperty->PropertyClass);
+	}
+};
+
+template<typename T>
+struct TEventNativeType<TSubclassOf<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FClassProperty* ClassProperty = CastField<const FClassProperty>(Property);
+		return ClassProperty && T::StaticClass()->IsChildOf(ClassProperty->MetaClass);
+	}
+};
+
+template<typename T>
+struct TEventNativeType<TSoftObjectPtr<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FSoftObjectProperty* ObjectProperty = CastField<const FSoftObjectProperty>(Property);
+		return ObjectProperty && !Property->IsA<FSoftClassProperty>() && T::StaticClass()->IsChildOf(ObjectProperty->PropertyClass);
+	}
+};
+
+template<typename T>
+struct TEventNativeType<TSoftClassPtr<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FSoftClassProperty* ClassProperty = CastField<const FSoftClassProperty>(Property);
+		return ClassProperty && T::StaticClass()->IsChildOf(ClassProperty->MetaClass);
+	}
+};
+
+/** T is the native interface, its UClassType is the class the property stores */
+template<typename T>
+struct TEventNativeType<TScriptInterface<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FInterfaceProperty* InterfaceProperty = CastField<const FInterfaceProperty>(Property);
+		return InterfaceProperty && T::UClassType::StaticClass()->IsChildOf(InterfaceProperty->InterfaceClass);
+	}
+};
+
+/** Detects USTRUCTs, which have a StaticStruct */
+template<typename T>
+struct THasEventStaticStruct
+{
+	template<typename U> static char Test(decltype(&U::StaticStruct));
+	template<typename U> static int32 Test(...);
+	enum { Value = sizeof(Test<T>(nullptr)) == sizeof(char) };
+};
+
+template<typename T>
+struct TEventNativeType<T, typename TEnableIf<THasEventStaticStruct<T>::Value>::Type>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FStructProperty* StructProperty = CastField<const FStructProperty>(Property);
+		return StructProperty && StructProperty->Struct == T::StaticStruct();
+	}
+};
+
+/** Core structs have no StaticStruct, their script struct comes from TBaseStructure */
+#define EVENT_NATIVE_BASE_STRUCT(Type) \
+	template<> struct TEventNativeType<Type> \
+	{ \
+		static bool Matches(const FProperty* Property) \
+		{ \
+			const FStructProperty* StructProperty = CastField<const FStructProperty>(Property); \
+			return StructProperty && StructProperty->Struct == TBaseStructure<Type>::Get(); \
+		} \
+	};
+
+EVENT_NATIVE_BASE_STRUCT(FVector)
+EVENT_NATIVE_BASE_STRUCT(FVector2D)
+EVENT_NATIVE_BASE_STRUCT(FRotator)
+EVENT_NATIVE_BASE_STRUCT(FQuat)
+EVENT_NATIVE_BASE_STRUCT(FTransform)
+EVENT_NATIVE_BASE_STRUCT(FLinearColor)
+EVENT_NATIVE_BASE_STRUCT(FColor)
+EVENT_NATIVE_BASE_STRUCT(FGuid)
+
+#undef EVENT_NATIVE_BASE_STRUCT
+
+template<typename T>
+struct TEventNativeType<TArray<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FArrayProperty* ArrayProperty = CastField<const FArrayProperty>(Property);
+		return ArrayProperty && TEventNativeType<T>::Matches(ArrayProperty->Inner);
+	}
+};
+
+template<typename T>
+struct TEventNativeType<TSet<T>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FSetProperty* SetProperty = CastField<const FSetProperty>(Property);
+		return SetProperty && TEventNativeType<T>::Matches(SetProperty->ElementProp);
+	}
+};
+
+template<typename K, typename V>
+struct TEventNativeType<TMap<K, V>>
+{
+	static bool Matches(const FProperty* Property)
+	{
+		const FMapProperty* MapProperty = CastField<const FMapProperty>(Property);
+		return MapProperty && TEventNativeType<K>::Matches(MapProperty->KeyProp) && TEventNativeType<V>::Matches(MapProperty->ValueProp);
+	}
+};
+
+/** A parameter as declared by the event dictionary. Type is an FEdGraphPinType exported to json */
+struct FEventParameterDesc
+{
+	FName Name;
+	FString Type;
+};
+
+/** Limits how often an event reaches its listeners, set per event in the dictionary */
+USTRUCT(BlueprintType)
+struct EVENTSYSTEMRUNTIME_API FEventThrottle
+{
+	GENERATED_BODY()
+
+	/** Most notifies delivered per second, bursts of up to this many (at least one) are let through. 0 disables the limit */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Event, meta = (ClampMin = "0"))
+	float MaxRate = 0.f;
+
+	/** Minimum seconds between two delivered notifies. 0 disables the limit */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Event, meta = (ClampMin = "0"))
+	float MinInterval = 0.f;
+
+	/** Deliver the latest suppressed payload as soon as the limits allow it, instead of dropping it */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Event)
+	bool bDeliverTrailing = false;
+
+	bool IsActive() const { return MaxRate > 0.f || MinInterval > 0.f; }
+};
+
+struct FEventPayload;
+
+/** Payloads are handed from notifying threads to the game thread, their reference count has to be atomic */
+typedef TSharedPtr<FEventPayload, ESPMode::ThreadSafe> FEventPayloadPtr;
+
+/** Delivery history of a throttled event */
+struct FEventThrottleState
+{
+	double LastDeliveryTime = 0.0;
+
+	/** Token bucket for MaxRate, refilled at MaxRate tokens per second up to MaxRate, or one token for rates below one */
+	double Tokens = 0.0;
+	double LastRefillTime = 0.0;
+
+	/** Latest suppressed notify, waiting for trailing delivery */
+	FEventPayloadPtr PendingPayload;
+	TWeakObjectPtr<UObject> PendingSender;
+
+	bool CanDeliver(const FEventThrottle& Throttle, double Now) const
+	{
+		if (Throttle.MinInterval > 0.f && Now - LastDeliveryTime < Throttle.MinInterval)
+		{
+			return false;
+		}
+		return Throttle.MaxRate <= 0.f || GetTokens(Throttle, Now) >= 1.0;
+	}
+
+	void Consume(const FEventThrottle& Throttle, double Now)
+	{
+		Tokens = GetTokens(Throttle, Now) - 1.0;
+		LastRefillTime = Now;
+		LastDeliveryTime = Now;
+	}
+
+private:
+	double GetTokens(const FEventThrottle& Throttle, double Now) const
+	{
+		// The bucket has to hold a whole token, or rates below one per second never deliver
+		return FMath::Min<double>(FMath::Max<double>(Throttle.MaxRate, 1.0), Tokens + (Now - LastRefillTime) * Throttle.MaxRate);
+	}
+};
+
+/**
+ * Parameter layout of a single event.
+ * Built once per event id from the dictionary declaration and the first listener bound to it,
+ * every later listener and every notify payload is checked against it so dispatch doesn't have to.
+ */
+struct EVENTSYSTEMRUNTIME_API FEventSchema
+{
+	typedef TArray<FProperty*, TInlineAllocator<8>> FParameterList;
+
+	/** Fills the declared types from the dictionary, returns false if a type could not be parsed */
+	bool SetDeclaration(const TArray<FEventParameterDesc>& Parameters, FString& OutError);
+
+	/** True once a listener function has fixed the property layout */
+	bool HasLayout() const { return LayoutFunction.IsValid(); }
+
+	/** Parameters of the layout function, empty until a listener was bound */
+	const FParameterList& GetLayout() const { return Layout; }
+
+	/** True if the dictionary declares the parameters of this event */
+	bool HasDeclaration() const { return bHasDeclaration; }
+
+	/** True if payloads can be copied, either with the listener layout or with the declared types */
+	bool HasPayloadLayout() const { return HasLayout() || bDeclaredLayoutComplete; }
+
+	/** Properties made from the declared types, empty unless every declared type has a runtime property */
+	const FParameterList& GetDeclaredLayout() const { return bDeclaredLayoutComplete ? DeclaredLayout : EmptyLayout(); }
+
+	/** Layout payloads are copied, packed and recorded with: the listener layout, else the declared one */
+	const FParameterList& GetPayloadLayout() const { return HasLayout() || !bDeclaredLayoutComplete ? Layout : DeclaredLayout; }
+
+	/** Makes Function the reference layout for this event. Function must already be validated */
+	void BindLayout(UFunction* Function);
+
+	/** Checks that Function takes exactly the parameters of this event */
+	bool ValidateFunction(const UFunction* Function, FString& OutError) const;
+
+	/** Checks that a notify payload can be copied into any validated listener, or matches the declared types while nobody listens */
+	bool ValidatePayload(const TArray<FOutputParam, TInlineAllocator<8>>& Params, FString& OutError) const;
+
+	/** True if the value of Param has the type of Property */
+	static bool ParamMatches(const FOutputParam& Param, const FProperty* Property);
+
+	/** Collects the input parameters of Function in declaration order */
+	static void GetParameters(const UFunction* Function, FParameterList& OutParameters);
+
+	/** Delivery limits declared by the dictionary */
+	FEventThrottle Throttle;
+
+private:
+	/** Pin types declared by the dictionary, only meaningful when bHasDeclaration is set */
+	TArray<FEdGraphPinType> DeclaredTypes;
+	bool bHasDeclaration = false;
+
+	/** Properties made from DeclaredTypes, null where a type has no runtime property. Shared by every schema, never freed */
+	FParameterList DeclaredLayout;
+	bool bDeclaredLayoutComplete = false;
+
+	static const FParameterList& EmptyLayout()
+	{
+		static const FParameterList Empty;
+		return Empty;
+	}
+
+	/** ValidatePayload against the declared types, used while no listener fixed the layout */
+	bool ValidateDeclaredPayload(const TArray<FOutputParam, TInlineAllocator<8>>& Params, FString& OutError) const;
+
+	/** Function whose parameters define the layout, and those parameters */
+	TWeakObjectPtr<UFunction> LayoutFunction;
+	FParameterList Layout;
+};
+
+/** Owns a copy of a payload laid out like an event schema, for notifies that outlive the caller's stack */
+struct EVENTSYSTEMRUNTIME_API FEventPayload
+{
+	/** Default constructed values, to be filled by Serialize */
+	explicit FEventPayload(const FEventSchema::FParameterList& InLayout);
+
+	/** Copies Params, which must have passed FEventSchema::ValidatePayload for InLayout */
+	FEventPayload(const FEventSchema::FParameterList& InLayout, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	~FEventPayload();
+
+	FEventPayload(const FEventPayload&) = delete;
+	FEventPayload& operator=(const FEventPayload&) = delete;
+
+	/** Serializes every value in layout order */
+	void Serialize(FArchive& Ar) { SerializeValues(Ar, Layout, Values); }
+
+	/** Serializes Values, laid out as Layout, without taking a copy */
+	static void SerializeValues(FArchive& Ar, const FEventSchema::FParameterList& Layout, const TArray<FOutputParam, TInlineAllocator<8>>& Values);
+
+	FEventSchema::FParameterList Layout;
+	TArray<FOutputParam, TInlineAllocator<8>> Values;
+};
@@ -0,0 +1,69 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "Systems/EventChannel.h"
+
+/**
+ * Uniform grid of the listeners that registered with a position source, one grid per event.
+ * Position sources report their moves, only the listeners that moved are sampled again, on the next radius notify of their event.
+ * Game thread only.
+ */
+class EVENTSYSTEMRUNTIME_API FEventSpatialIndex
+{
+public:
+	~FEventSpatialIndex() { Reset(); }
+
+	void Add(const FEventHandle& Handle, USceneComponent* PositionSource);
+	void Remove(const FEventHandle& Handle);
+	void RemoveListener(const UObject* Listener);
+
+	/** Drops the listeners whose handle matches Predicate */
+	void RemoveListeners(TFunctionRef<bool(const FEventHandle&)> Predicate);
+	void Reset();
+
+	/** Collects the handles of EventId whose position source lies within Radius of Location */
+	void Query(const FString& EventId, const FVector& Location, float Radius, TArray<FEventHandle>& OutHandles);
+
+private:
+	struct FSpatialListener
+	{
+		FEventHandle Handle;
+		TWeakObjectPtr<USceneComponent> PositionSource;
+		FDelegateHandle TransformUpdatedHandle;
+		FVector Location = FVector::ZeroVector;
+		FIntVector Cell = FIntVector::ZeroValue;
+		bool bInCell = false;
+		bool bMoved = true;
+	};
+
+	struct FSpatialEvent
+	{
+		/** Sparse so the indices held by the cells survive listeners leaving */
+		TSparseArray<FSpatialListener> Listeners;
+
+		/** Indices into Listeners per grid cell */
+		TMap<FIntVector, TArray<int32>> Cells;
+
+		/** Listeners whose position source moved since the last query, may hold stale indices */
+		TArray<int32> Moved;
+
+		/** Cell size the grid was built with, all cells are rebuilt when it changes */
+		float CellSize = 0.f;
+	};
+
+	/** Moves the listeners that moved to their current cell, drops those whose position source is gone */
+	static void UpdateMoved(FSpatialEvent& Event, float CellSize);
+
+	/** Unbinds and drops the listener at Index */
+	static void RemoveAt(FSpatialEvent& Event, int32 Index);
+
+	static void OnTransformUpdated(USceneComponent* Component, EUpdateTransformFlags Flags, ETeleportType Teleport, FSpatialEvent* Event, int32 Index);
+
+	static FIntVector GetCell(const FVector& Location, float CellSize);
+
+	/** Events are heap allocated, the transform callbacks of their listeners point at them */
+	TMap<FString, TUniquePtr<FSpatialEvent>> Events;
+};
@@ -5,56 +5,10 @@
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Templates/Tuple.h"
-#include <tuple>
+#include "Systems/EventChannel.h"
+#include "Systems/EventRecorder.h"
 #include "GIEventSubsystem.generated.h"
 
-struct FOutputParam
-{
-	FProperty* Property = nullptr;
-	uint8* PropAddr = nullptr;
-};
-
-USTRUCT(BlueprintType)
-struct FEventHandle
-{
-	GENERATED_USTRUCT_BODY();
-public:
-	FEventHandle() :
-		Listener(nullptr),
-		EventName(TEXT("")),
-		MsgId(TEXT(""))
-	{};
-
-	FEventHandle(UObject* InListener, FName InEventName, FName InMsgID);
-
-	friend bool operator==(const FEventHandle& Lhs, const FEventHandle& Rhs)
-	{
-		return Lhs.EventName == Rhs.EventName 
-			&& Lhs.Listener.Get() == Rhs.Listener.Get() && Lhs.MsgId == Rhs.MsgId;
-	}
-
-	friend bool operator!=(const FEventHandle& Lhs, const FEventHandle& Rhs)
-	{
-		return Lhs.EventName != Rhs.EventName
-			|| Lhs.Listener.Get() != Rhs.Listener.Get() || Lhs.MsgId != Rhs.MsgId;
-	}
-	friend uint32 GetTypeHash(const FEventHandle& Handle)
-	{
-		return (GetTypeHash(Handle.MsgId) + 12 * GetTypeHash(Handle.Listener.Get()) + 23 * GetTypeHash(Handle.EventName));
-	}
-
-	FORCEINLINE FString ToString() const
-	{
-		FString ListenerName = Listener.Get() && Listener.Get()->IsValidLowLevel() ? Listener.Get()->GetName() : TEXT("");
-		return FString::Printf(TEXT("MsgID : %s; EventName: %s; Listener : %s"),*MsgId.ToString(),*EventName.ToString(), *ListenerName);
-	}
-	FName GetMsgId() { return MsgId; }
-public:
-	TWeakObjectPtr<UObject> Listener;
-	FName EventName;
-	FName MsgId;
-};
-
 /**
  * 
  */
@@ -68,50 +22,36 @@ public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 
-	void NotifyEventWithParams(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames);
-	const FEventHandle ListenEvent(const FString& MessageId, UObject* Listener, FName EventName);
-	void UnListenEvent(const FEventHandle& InHandle);
-	void UnListenEvents(UObject* Listener); // FIX (blowpunch)
+	void NotifyEventWithParams(const FString& EventId, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Outparames) { Channel.NotifyEventWithParams(EventId, Sender, Outparames); }
+	const FEventHandle ListenEvent(const FString& MessageId, UObject* Listener, FName EventName) { return Channel.ListenEvent(MessageId, Listener, EventName); }
+	void UnListenEvent(const FEventHandle& InHandle) { Channel.UnListenEvent(InHandle); }
+	void UnListenEvents(UObject* Listener) { Channel.UnListenEvents(Listener); } // FIX (blowpunch)
+	FDelegateHandle ListenEventNative(const FString& EventId, FOnEventNotified Callback, const UObject* Owner = nullptr, bool bAnyThread = false) { return Channel.ListenEventNative(EventId, MoveTemp(Callback), Owner, bAnyThread); }
+	void UnListenEventNative(const FString& EventId, FDelegateHandle Handle) { Channel.UnListenEventNative(EventId, Handle); }
 
 	static UGIEventSubsystem* Get(const UObject* WorldContext);
 
 	template<typename... TArgs>
-	void NotifyEvent(const FString& EventId, UObject* Sender, TArgs&&... Args);
-
-private:
-	TMap<FString, TSet<FEventHandle>> ListenerMap;
-};
-
-template<typename T>
-FOutputParam MakeOutputParam(T& t)
-{
-	FOutputParam OutputParam;
-	OutputParam.PropAddr = (uint8*)std::addressof(t);
-	return OutputParam;
-}
+	void NotifyEvent(const FString& EventId, UObject* Sender, TArgs&&... Args)
+	{
+		Channel.NotifyEvent(EventId, Sender, Forward<TArgs>(Args)...);
+	}
 
-template<typename T,size_t... Is>
-TArray<FOutputParam, TInlineAllocator<8>> MakeOutputParamFromTuple(T& Tuple, const std::index_sequence<Is...>&)
-{
-	return TArray<FOutputParam, TInlineAllocator<8>>{MakeOutputParam(std::get<Is>(Tuple))...};
-}
+	FEventChannel& GetChannel() { return Channel; }
 
-template<typename T>
-TArray<FOutputParam, TInlineAllocator<8>> MakeParam(T& tup)
-{
-	return MakeOutputParamFromTuple(tup, std::make_index_sequence<std::tuple_size<T>::value>());
-}
+	/** Appends every notify of this game instance to Filename, relative paths go to Saved/EventLogs */
+	bool StartRecording(const FString& Filename);
+	void StopRecording() { Recorder.Stop(); }
 
+	/** Replays a recorded log, PlaybackRate 0 or less dispatches the whole log at once */
+	bool StartReplay(const FString& Filename, float PlaybackRate = 1.f);
+	void StopReplay() { Replayer.Stop(); }
 
-template<typename... TArgs>
-void UGIEventSubsystem::NotifyEvent(const FString& EventId, UObject* Sender, TArgs&&... Args)
-{
-	//暂时注释看看下边支持情况不行在改回来
-	//std::tuple<TArgs...> InParams(std::forward<TArgs>(Args)...);
-	//TArray<FOutputParam, TInlineAllocator<8>> OutputParam = MakeParam(InParams);
+	static FString GetEventLogPath(const FString& Filename);
 
-	// c++14 支持
-	TArray<FOutputParam, TInlineAllocator<8>> VOutputParam = { MakeOutputParam(Args)... };
+private:
+	FEventChannel Channel;
 
-	this->NotifyEventWithParams(EventId, Sender, VOutputParam);
-}
+	FEventRecorder Recorder;
+	FEventReplayer Replayer;
+};
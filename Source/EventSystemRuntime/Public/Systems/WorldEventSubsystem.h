@@ -0,0 +1,72 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Systems/EventChannel.h"
+#include "Systems/EventSpatialIndex.h"
+#include "WorldEventSubsystem.generated.h"
+
+class ULevel;
+class USceneComponent;
+
+/**
+ * Owns the world channel and one channel per loaded level.
+ * Level channels are dropped as soon as their level is removed from the world, listeners don't need to unlisten.
+ */
+UCLASS()
+class EVENTSYSTEMRUNTIME_API UWorldEventSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UWorldEventSubsystem() : WorldChannel(EEventScope::World) {};
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	static UWorldEventSubsystem* Get(const UObject* WorldContext);
+
+	FEventChannel& GetWorldChannel() { return WorldChannel; }
+
+	/** Returns the channel of Level, nullptr if nothing listens in it yet */
+	FEventChannel* FindLevelChannel(const ULevel* Level);
+	FEventChannel& FindOrAddLevelChannel(const ULevel* Level);
+
+	/** Level an object belongs to, the persistent level for objects outside any level */
+	ULevel* GetLevelOf(const UObject* Object) const;
+
+	/**
+	 * Listens in the world channel and tracks the position of PositionSource for radius notifies.
+	 * Without a position source the root component of the listener's actor is used.
+	 */
+	FEventHandle ListenEventSpatial(const FString& EventId, UObject* Listener, FName EventName, USceneComponent* PositionSource = nullptr);
+	void UnListenEventSpatial(const FEventHandle& Handle) { UnListenEvent(Handle); }
+
+	/** Unlistens from the world channel, spatial listeners are dropped from the index as well */
+	void UnListenEvent(const FEventHandle& Handle);
+	void UnListenEvents(UObject* Listener);
+
+	/** Notifies the spatial listeners of EventId within Radius of Location, plain world listeners are not reached */
+	void NotifyEventInRadiusWithParams(const FString& EventId, UObject* Sender, const FVector& Location, float Radius, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	template<typename... TArgs>
+	void NotifyEventInRadius(const FString& EventId, UObject* Sender, const FVector& Location, float Radius, TArgs&&... Args)
+	{
+		TArray<FOutputParam, TInlineAllocator<8>> Params = { MakeOutputParam(Args)... };
+		NotifyEventInRadiusWithParams(EventId, Sender, Location, Radius, Params);
+	}
+
+private:
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	FEventChannel WorldChannel;
+
+	/** Channels are heap allocated so a notify keeps a stable channel while listeners add levels */
+	TMap<TObjectKey<ULevel>, TUniquePtr<FEventChannel>> LevelChannels;
+
+	FEventSpatialIndex SpatialIndex;
+
+	FDelegateHandle LevelRemovedHandle;
+};
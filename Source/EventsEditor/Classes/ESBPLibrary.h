@@ -12,6 +12,9 @@ class EVENTSEDITOR_API UESBPLibrary : public UBlueprintFunctionLibrary
 
 public:
 	static FString GetParameterType(const FEdGraphPinType& Type);
+
+	/** C++ spelling of a pin type, empty if it involves a type only blueprints can see */
+	static FString GetNativeParameterType(const FEdGraphPinType& Type);
 	static FString GetCppName(FFieldVariant Field, bool bUInterface = false, bool bForceParameterNameModification = false);
 	static int32 GetInheritenceLevel(const UStruct* Struct);
 	static bool GetPinTypeFromStr(const FString& PinTypeStr, FEdGraphPinType& PinType);
@@ -0,0 +1,28 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "EventsCodeGenCommandlet.generated.h"
+
+/**
+ * Writes a C++ header with an id constant and typed Notify/Listen wrappers for every dictionary event.
+ * Usage: UE4Editor-Cmd.exe <Project> -run=EventsCodeGen [-Output=<Header>] [-Namespace=<Name>]
+ * The header is only rewritten when its content changes, so it doesn't trigger needless rebuilds.
+ * Fails without writing anything when two events map to the same identifier.
+ */
+UCLASS()
+class UEventsCodeGenCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Header declaring a native type, empty if CoreMinimal already has it */
+	static FString GetIncludePath(const UObject* Type);
+
+	/** Tag name turned into a C++ identifier, keywords get a trailing underscore */
+	static FString GetIdentifier(FName TagName);
+};
@@ -9,6 +9,7 @@
 #include "EventsRuntime/Classes/EventContainer.h"
 #include "Stats/StatsHierarchical.h"
 #include "K2Node_EditablePinBase.h"
+#include "Systems/EventChannel.h"
 #include "EventsK2Node_EventBase.generated.h"
 
 class FBlueprintActionDatabaseRegistrar;
@@ -25,6 +26,10 @@ class UEventsK2Node_EventBase : public UK2Node
 	UPROPERTY(EditAnywhere, Category = PinOptions)
 	TArray<FEventInfo> PinTags;
 
+	/** Channel the node notifies or listens in */
+	UPROPERTY(EditAnywhere, Category = PinOptions)
+	EEventScope Scope = EEventScope::GameInstance;
+
 	TArray< TSharedPtr<FUserPinInfo> >UserDefinedPins;
 
 	UPROPERTY()
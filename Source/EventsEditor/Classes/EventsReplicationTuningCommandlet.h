@@ -0,0 +1,21 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "EventsReplicationTuningCommandlet.generated.h"
+
+/**
+ * Turns a replication report saved with Events.WriteReport into the CommonlyReplicatedTags order and
+ * NetIndexFirstBitSegment that replicate the captured tags in the fewest bits, and estimates the saving.
+ * Usage: UE4Editor-Cmd.exe <Project> -run=EventsReplicationTuning [-Report=<File>] [-Apply]
+ * -Apply writes the result to the Events settings in DefaultEvents.ini.
+ */
+UCLASS()
+class UEventsReplicationTuningCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,20 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "EventsSnapshotCommandlet.generated.h"
+
+/**
+ * Writes the binary dictionary snapshot that cooked builds load instead of the ini files and data tables.
+ * Usage: UE4Editor-Cmd.exe <Project> -run=EventsSnapshot [-Output=<File>]
+ * Run it before cooking and add Events to DirectoriesToAlwaysStageAsNonUFS so the file can be memory mapped.
+ */
+UCLASS()
+class UEventsSnapshotCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
@@ -141,6 +141,105 @@ FString UESBPLibrary::GetParameterType(const FEdGraphPinType& Type)
 	return SyncStatusJsonString;
 }
 
+FString UESBPLibrary::GetNativeParameterType(const FEdGraphPinType& Type)
+{
+	auto GetTerminalType = [](FName Category, UObject* SubCategoryObject) -> FString
+	{
+		if (SubCategoryObject && !SubCategoryObject->IsNative())
+		{
+			return FString();
+		}
+
+		UClass* Class = Cast<UClass>(SubCategoryObject);
+		if (Category == UEdGraphSchema_K2::PC_Boolean)
+		{
+			return TEXT("bool");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Byte || Category == UEdGraphSchema_K2::PC_Enum)
+		{
+			if (UEnum* Enum = Cast<UEnum>(SubCategoryObject))
+			{
+				const FString EnumName = !Enum->CppType.IsEmpty() ? Enum->CppType : Enum->GetName();
+				return Enum->GetCppForm() == UEnum::ECppForm::EnumClass ? EnumName : FString::Printf(TEXT("TEnumAsByte<%s>"), *EnumName);
+			}
+			return TEXT("uint8");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Int)
+		{
+			return TEXT("int32");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Int64)
+		{
+			return TEXT("int64");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Float)
+		{
+			return TEXT("float");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Name)
+		{
+			return TEXT("FName");
+		}
+		if (Category == UEdGraphSchema_K2::PC_String)
+		{
+			return TEXT("FString");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Text)
+		{
+			return TEXT("FText");
+		}
+		if (Category == UEdGraphSchema_K2::PC_Struct && Cast<UScriptStruct>(SubCategoryObject))
+		{
+			return GetCppName(Cast<UScriptStruct>(SubCategoryObject));
+		}
+		if (Class)
+		{
+			if (Category == UEdGraphSchema_K2::PC_Object)
+			{
+				return GetCppName(Class) + TEXT("*");
+			}
+			if (Category == UEdGraphSchema_K2::PC_Class)
+			{
+				return FString::Printf(TEXT("TSubclassOf<%s>"), *GetCppName(Class));
+			}
+			if (Category == UEdGraphSchema_K2::PC_SoftObject)
+			{
+				return FString::Printf(TEXT("TSoftObjectPtr<%s>"), *GetCppName(Class));
+			}
+			if (Category == UEdGraphSchema_K2::PC_SoftClass)
+			{
+				return FString::Printf(TEXT("TSoftClassPtr<%s>"), *GetCppName(Class));
+			}
+			if (Category == UEdGraphSchema_K2::PC_Interface)
+			{
+				return FString::Printf(TEXT("TScriptInterface<%s>"), *GetCppName(Class));
+			}
+		}
+		return FString();
+	};
+
+	const FString InnerType = GetTerminalType(Type.PinCategory, Type.PinSubCategoryObject.Get());
+	if (InnerType.IsEmpty())
+	{
+		return InnerType;
+	}
+
+	switch (Type.ContainerType)
+	{
+	case EPinContainerType::Array:
+		return FString::Printf(TEXT("TArray<%s>"), *InnerType);
+	case EPinContainerType::Set:
+		return FString::Printf(TEXT("TSet<%s>"), *InnerType);
+	case EPinContainerType::Map:
+	{
+		const FString ValueType = GetTerminalType(Type.PinValueType.TerminalCategory, Type.PinValueType.TerminalSubCategoryObject.Get());
+		return ValueType.IsEmpty() ? ValueType : FString::Printf(TEXT("TMap<%s, %s>"), *InnerType, *ValueType);
+	}
+	default:
+		return InnerType;
+	}
+}
+
 FString UESBPLibrary::GetCppName(FFieldVariant Field, bool bUInterface /*= false*/, bool bForceParameterNameModification /*= false*/)
 {
 	check(Field);
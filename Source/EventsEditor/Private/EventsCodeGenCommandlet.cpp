@@ -0,0 +1,241 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventsCodeGenCommandlet.h"
+#include "ESBPLibrary.h"
+#include "EventsManager.h"
+#include "EdGraph/EdGraphPin.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/CommandLine.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEventsCodeGen, Log, All);
+
+UEventsCodeGenCommandlet::UEventsCodeGenCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UEventsCodeGenCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FPaths::Combine(FPaths::GameSourceDir(), FApp::GetProjectName(), TEXT("Generated"), TEXT("EventIds.h"));
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString Namespace = TEXT("Events");
+	FParse::Value(*Params, TEXT("Namespace="), Namespace);
+
+	UEventsManager& Manager = UEventsManager::Get();
+	const FEventDictionaryPtr Dictionary = Manager.GetDictionary();
+	if (!Dictionary)
+	{
+		UE_LOG(LogEventsCodeGen, Error, TEXT("The event dictionary isn't built, nothing to generate"));
+		return 1;
+	}
+
+	FEventContainer AllEvents;
+	Manager.RequestAllEvents(AllEvents, true);
+
+	TArray<FEventInfo> Events;
+	AllEvents.GetEventArray(Events);
+	Events.Sort([](const FEventInfo& A, const FEventInfo& B) { return A.GetTagName().LexicalLess(B.GetTagName()); });
+
+	// Tags that only differ in characters C++ can't spell would silently share an identifier
+	TMap<FString, FName> IdentifierTags;
+	int32 NumCollisions = 0;
+
+	TSet<FString> Includes;
+	FString Ids;
+	FString Keys;
+	FString Wrappers;
+	int32 NumTyped = 0;
+
+	for (const FEventInfo& Event : Events)
+	{
+		const int32 Entry = Dictionary->Find(Event);
+		if (Entry == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FString Identifier = GetIdentifier(Event.GetTagName());
+		if (const FName* OtherTag = IdentifierTags.Find(Identifier))
+		{
+			UE_LOG(LogEventsCodeGen, Error, TEXT("%s and %s both map to the identifier %s, rename one of them"), *OtherTag->ToString(), *Event.ToString(), *Identifier);
+			++NumCollisions;
+			continue;
+		}
+		IdentifierTags.Add(Identifier, Event.GetTagName());
+
+		Ids += FString::Printf(TEXT("\t\tconstexpr const TCHAR* %s = TEXT(\"%s\");\n"), *Identifier, *Event.GetTagName().ToString());
+
+		// The id is registered once, every later notify only reads the integer key. Ids is qualified since an event may be called Ids
+		Keys += FString::Printf(TEXT("\t\tinline FEventKey %s()\n\t\t{\n\t\t\tstatic const FEventKey Key = FEventKey::FindOrAdd(%s::Ids::%s);\n\t\t\treturn Key;\n\t\t}\n"), *Identifier, *Namespace, *Identifier);
+
+		// Every parameter needs a native spelling, otherwise only the untyped listen is generated
+		TArray<FString> Types;
+		TArray<FString> Names;
+		FString Unsupported;
+		const TArray<FEventParameterDesc>& Parameters = Dictionary->GetEntryData(Entry).Parameters;
+		for (int32 Index = 0; Index < Parameters.Num(); ++Index)
+		{
+			const FEventParameterDesc& Parameter = Parameters[Index];
+			FEdGraphPinType PinType;
+			FString Type = UESBPLibrary::GetPinTypeFromStr(Parameter.Type, PinType) ? UESBPLibrary::GetNativeParameterType(PinType) : FString();
+			if (Type.IsEmpty())
+			{
+				Unsupported = Parameter.Name.ToString();
+				break;
+			}
+
+			for (const UObject* SubCategoryObject : { PinType.PinSubCategoryObject.Get(), PinType.PinValueType.TerminalSubCategoryObject.Get() })
+			{
+				const FString IncludePath = GetIncludePath(SubCategoryObject);
+				if (!IncludePath.IsEmpty())
+				{
+					Includes.Add(IncludePath);
+				}
+			}
+
+			// Parameter names that collide fall back to their position
+			FString Name = TEXT("In") + (Parameter.Name.IsNone() ? FString::Printf(TEXT("Param%d"), Index) : GetIdentifier(Parameter.Name));
+			if (Names.Contains(Name))
+			{
+				Name = FString::Printf(TEXT("InParam%d"), Index);
+			}
+			Types.Add(MoveTemp(Type));
+			Names.Add(MoveTemp(Name));
+		}
+
+		FString DevComment;
+		FName TagSource;
+		bool bIsExplicit, bIsRestricted, bAllowNonRestrictedChildren;
+		Wrappers += TEXT("\n");
+		if (Manager.GetTagEditorData(Event.GetTagName(), DevComment, TagSource, bIsExplicit, bIsRestricted, bAllowNonRestrictedChildren) && !DevComment.IsEmpty())
+		{
+			Wrappers += FString::Printf(TEXT("\t/** %s */\n"), *DevComment.Replace(TEXT("*/"), TEXT("* /")));
+		}
+
+		Wrappers += FString::Printf(TEXT("\tinline const FEventHandle Listen_%s(FEventChannel& Channel, UObject* Listener, FName FunctionName)\n\t{\n"), *Identifier);
+		Wrappers += FString::Printf(TEXT("\t\tstatic const FString Id(Ids::%s);\n\t\treturn Channel.ListenEvent(Id, Listener, FunctionName);\n\t}\n"), *Identifier);
+
+		if (!Unsupported.IsEmpty())
+		{
+			UE_LOG(LogEventsCodeGen, Warning, TEXT("%s: parameter %s has no native type, skipping the typed wrappers"), *Event.ToString(), *Unsupported);
+			continue;
+		}
+
+		FString Signature;
+		FString Arguments;
+		FString CallbackTypes;
+		FString CallbackArguments;
+		for (int32 Index = 0; Index < Types.Num(); ++Index)
+		{
+			Signature += FString::Printf(TEXT(", const %s& %s"), *Types[Index], *Names[Index]);
+			Arguments += FString::Printf(TEXT(", %s"), *Names[Index]);
+			CallbackTypes += FString::Printf(TEXT("%sconst %s&"), Index ? TEXT(", ") : TEXT(""), *Types[Index]);
+			CallbackArguments += FString::Printf(TEXT("%s*(const %s*)Params[%d].PropAddr"), Index ? TEXT(", ") : TEXT(""), *Types[Index], Index);
+		}
+
+		Wrappers += FString::Printf(TEXT("\n\tinline void Notify_%s(FEventChannel& Channel, UObject* Sender%s)\n\t{\n"), *Identifier, *Signature);
+		Wrappers += FString::Printf(TEXT("\t\tChannel.NotifyEvent(Keys::%s(), Sender%s);\n\t}\n"), *Identifier, *Arguments);
+
+		Wrappers += FString::Printf(TEXT("\n\tinline FDelegateHandle ListenNative_%s(FEventChannel& Channel, TFunction<void(%s)> Callback, const UObject* Owner = nullptr, bool bAnyThread = false)\n\t{\n"), *Identifier, *CallbackTypes);
+		Wrappers += FString::Printf(TEXT("\t\treturn Channel.ListenEventNative(Keys::%s(), FOnEventNotified::CreateLambda([Callback](const TArray<FOutputParam, TInlineAllocator<8>>& Params)\n\t\t{\n"), *Identifier);
+		Wrappers += FString::Printf(TEXT("\t\t\tif (Params.Num() == %d)\n\t\t\t{\n\t\t\t\tCallback(%s);\n\t\t\t}\n"), Types.Num(), *CallbackArguments);
+		Wrappers += TEXT("\t\t}), Owner, bAnyThread);\n\t}\n");
+		++NumTyped;
+	}
+
+	if (NumCollisions)
+	{
+		UE_LOG(LogEventsCodeGen, Error, TEXT("%d events have colliding identifiers, %s was not written"), NumCollisions, *OutputPath);
+		return 1;
+	}
+
+	TArray<FString> SortedIncludes = Includes.Array();
+	SortedIncludes.Sort();
+
+	FString Header = TEXT("// Generated by the EventsCodeGen commandlet from the event dictionary, do not edit.\n\n#pragma once\n\n#include \"CoreMinimal.h\"\n#include \"Systems/EventChannel.h\"\n");
+	for (const FString& Include : SortedIncludes)
+	{
+		Header += FString::Printf(TEXT("#include \"%s\"\n"), *Include);
+	}
+	Header += FString::Printf(TEXT("\nnamespace %s\n{\n\tnamespace Ids\n\t{\n%s\t}\n\n\tnamespace Keys\n\t{\n%s\t}\n%s}\n"), *Namespace, *Ids, *Keys, *Wrappers);
+
+	FString Existing;
+	if (FFileHelper::LoadFileToString(Existing, *OutputPath) && Existing == Header)
+	{
+		UE_LOG(LogEventsCodeGen, Display, TEXT("%s is up to date"), *OutputPath);
+		return 0;
+	}
+
+	if (!FFileHelper::SaveStringToFile(Header, *OutputPath))
+	{
+		UE_LOG(LogEventsCodeGen, Error, TEXT("Can't write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogEventsCodeGen, Display, TEXT("Wrote %d events (%d typed) to %s"), Events.Num(), NumTyped, *OutputPath);
+	return 0;
+}
+
+FString UEventsCodeGenCommandlet::GetIncludePath(const UObject* Type)
+{
+	const UField* Field = Cast<UField>(Type);
+	if (!Field || Field->GetOutermost()->GetFName() == TEXT("/Script/CoreUObject"))
+	{
+		return FString();
+	}
+
+	if (Field->HasMetaData(TEXT("IncludePath")))
+	{
+		return Field->GetMetaData(TEXT("IncludePath"));
+	}
+
+	// Structs and enums only know their path relative to the module, the include roots are Public and Classes
+	FString Path = Field->GetMetaData(TEXT("ModuleRelativePath"));
+	if (!Path.RemoveFromStart(TEXT("Public/")))
+	{
+		Path.RemoveFromStart(TEXT("Classes/"));
+	}
+	return Path;
+}
+
+FString UEventsCodeGenCommandlet::GetIdentifier(FName TagName)
+{
+	FString Identifier = TagName.ToString();
+	for (TCHAR& Char : Identifier)
+	{
+		if (!FChar::IsAlnum(Char))
+		{
+			Char = TEXT('_');
+		}
+	}
+	if (FChar::IsDigit(Identifier[0]))
+	{
+		return TEXT("_") + Identifier;
+	}
+
+	static const TSet<FString> Keywords = {
+		TEXT("alignas"), TEXT("alignof"), TEXT("and"), TEXT("and_eq"), TEXT("asm"), TEXT("auto"), TEXT("bitand"), TEXT("bitor"),
+		TEXT("bool"), TEXT("break"), TEXT("case"), TEXT("catch"), TEXT("char"), TEXT("char16_t"), TEXT("char32_t"), TEXT("class"),
+		TEXT("compl"), TEXT("const"), TEXT("constexpr"), TEXT("const_cast"), TEXT("continue"), TEXT("decltype"), TEXT("default"),
+		TEXT("delete"), TEXT("do"), TEXT("double"), TEXT("dynamic_cast"), TEXT("else"), TEXT("enum"), TEXT("explicit"), TEXT("export"),
+		TEXT("extern"), TEXT("false"), TEXT("float"), TEXT("for"), TEXT("friend"), TEXT("goto"), TEXT("if"), TEXT("inline"), TEXT("int"),
+		TEXT("long"), TEXT("mutable"), TEXT("namespace"), TEXT("new"), TEXT("noexcept"), TEXT("not"), TEXT("not_eq"), TEXT("nullptr"),
+		TEXT("operator"), TEXT("or"), TEXT("or_eq"), TEXT("private"), TEXT("protected"), TEXT("public"), TEXT("register"),
+		TEXT("reinterpret_cast"), TEXT("return"), TEXT("short"), TEXT("signed"), TEXT("sizeof"), TEXT("static"), TEXT("static_assert"),
+		TEXT("static_cast"), TEXT("struct"), TEXT("switch"), TEXT("template"), TEXT("this"), TEXT("thread_local"), TEXT("throw"),
+		TEXT("true"), TEXT("try"), TEXT("typedef"), TEXT("typeid"), TEXT("typename"), TEXT("union"), TEXT("unsigned"), TEXT("using"),
+		TEXT("virtual"), TEXT("void"), TEXT("volatile"), TEXT("wchar_t"), TEXT("while"), TEXT("xor"), TEXT("xor_eq"),
+		// Macros the generated header itself expands
+		TEXT("TEXT"),
+	};
+
+	// Keywords are case sensitive, TSet<FString> compares case insensitively so check the exact spelling
+	const FString* Keyword = Keywords.Find(Identifier);
+	return Keyword && Keyword->Equals(Identifier, ESearchCase::CaseSensitive) ? Identifier + TEXT("_") : Identifier;
+}
@@ -33,6 +33,8 @@
 #include "EventReferenceHelperDetails.h"
 #include "HAL/IConsoleManager.h"
 #include "Misc/FileHelper.h"
+#include "GameDelegates.h"
+#include "EventDictionarySnapshot.h"
 
 #define LOCTEXT_NAMESPACE "EventEditor"
 
@@ -47,6 +49,41 @@ public:
 	virtual void StartupModule() override
 	{
 		FCoreDelegates::OnPostEngineInit.AddRaw(this, &FEventsEditorModule::OnPostEngineInit);
+		FGameDelegates::Get().GetModifyCookDelegate().AddRaw(this, &FEventsEditorModule::OnModifyCook);
+	}
+
+	/** Cooked builds trust the staged snapshot as is, so a snapshot whose sources changed since it was written is written again here */
+	void OnModifyCook(TArray<FName>& PackagesToCook, TArray<FName>& PackagesToNeverCook)
+	{
+		// Projects opt in by writing the snapshot with the EventsSnapshot commandlet once
+		const FString SnapshotPath = FEventDictionarySnapshot::GetDefaultFilename();
+		if (!FPlatformFileManager::Get().GetPlatformFile().FileExists(*SnapshotPath))
+		{
+			return;
+		}
+
+		UEventsManager& Manager = UEventsManager::Get();
+		{
+			// Scoped so the mapping is released before the file is written over
+			TUniquePtr<FEventDictionarySnapshot> Snapshot = FEventDictionarySnapshot::Open(SnapshotPath);
+			if (Snapshot.IsValid())
+			{
+				const FEventDictionarySnapshot::FHeader& Header = Snapshot->GetHeader();
+				if (Header.IniHash == Manager.GetIniSourceHash() && Header.TableHash == Manager.GetEventTableHash() && Header.NetworkHash == Manager.GetNetworkEventNodeIndexHash())
+				{
+					return;
+				}
+			}
+		}
+
+		if (FEventDictionarySnapshot::Write(Manager, SnapshotPath))
+		{
+			UE_LOG(LogEvents, Display, TEXT("The event sources changed since %s was written, wrote it again"), *SnapshotPath);
+		}
+		else
+		{
+			UE_LOG(LogEvents, Error, TEXT("The event sources changed since %s was written and it can't be written again, the cooked build will use stale events"), *SnapshotPath);
+		}
 	}
 	
 	void OnPostEngineInit()
@@ -110,6 +147,7 @@ public:
 	virtual void ShutdownModule() override
 	{
 		FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+		FGameDelegates::Get().GetModifyCookDelegate().RemoveAll(this);
 
 		// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 		// we call this function before unloading the module.
@@ -484,10 +522,17 @@ public:
 		}
 
 		{
-			FString PerfMessage = FString::Printf(TEXT("ConstructEventTree Event tables after adding new tag"));
+			FString PerfMessage = FString::Printf(TEXT("Incremental event tree update after adding new tag"));
 			SCOPE_LOG_TIME_IN_SECONDS(*PerfMessage, nullptr)
 
-			Manager.EditorRefreshEventTree();
+			if (bIsRestrictedTag)
+			{
+				Manager.AddEventIncremental(FRestrictedEventTableRow(NewTagName, Comment, bAllowNonRestrictedChildren, Parameters), TagSourceName, true);
+			}
+			else
+			{
+				Manager.AddEventIncremental(FEventTableRow(NewTagName, Comment, Parameters), TagSourceName);
+			}
 		}
 
 		return true;
@@ -629,7 +674,7 @@ public:
 				}
 
 				// This invalidates all local variables, need to return right away
-				Manager.EditorRefreshEventTree();
+				Manager.RemoveEventIncremental(TagName);
 
 				return true;
 			}
@@ -778,7 +823,11 @@ public:
 
 		ShowNotification(FText::Format(LOCTEXT("AddEventRedirect", "Renamed event {0} to {1}"), FText::FromString(TagToRename), FText::FromString(TagToRenameTo)), 3.0f);
 
-		Manager.EditorRefreshEventTree();
+		// Tags with children move a whole subtree, those still take a full refresh
+		if (!Manager.RenameEventIncremental(OldTagName, NewTagName))
+		{
+			Manager.EditorRefreshEventTree();
+		}
 
 		return true;
 	}
@@ -795,10 +844,10 @@ public:
 		Manager.TransientEditorTags.Add(*NewTransientTag);
 
 		{
-			FString PerfMessage = FString::Printf(TEXT("ConstructEventTree Event tables after adding new transient tag"));
+			FString PerfMessage = FString::Printf(TEXT("Incremental event tree update after adding new transient tag"));
 			SCOPE_LOG_TIME_IN_SECONDS(*PerfMessage, nullptr)
 
-			Manager.EditorRefreshEventTree();
+			Manager.AddEventIncremental(FEventTableRow(*NewTransientTag), FEventSource::GetTransientEditorName());
 		}
 
 		return true;
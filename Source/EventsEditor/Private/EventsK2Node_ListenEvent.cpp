@@ -81,7 +81,7 @@ void UEventsK2Node_ListenEvent::ExpandNode(class FKismetCompilerContext& Compile
 		}
 	}
 
-	static const FName FuncName = GET_FUNCTION_NAME_CHECKED(UEventSystemBPLibrary, ListenEventByKey);
+	static const FName FuncName = GET_FUNCTION_NAME_CHECKED(UEventSystemBPLibrary, ListenEventByKeyInScope);
 
 	UEventsK2Node_ListenEvent* SpawnNode = this;
 	UEdGraphPin* SpawnEventExec = GetExecPin();
@@ -108,6 +108,9 @@ void UEventsK2Node_ListenEvent::ExpandNode(class FKismetCompilerContext& Compile
 	UEdGraphPin* CallEventNamePin = CallNotifyFuncNode->FindPinChecked(TEXT("EventName"));
 	CallEventNamePin->DefaultValue = CustomEventNode->CustomFunctionName.ToString();
 
+	UEdGraphPin* CallScopePin = CallNotifyFuncNode->FindPinChecked(TEXT("Scope"));
+	CallScopePin->DefaultValue = StaticEnum<EEventScope>()->GetNameStringByValue((int64)Scope);
+
 	UEdGraphPin* CallThen = CallNotifyFuncNode->GetThenPin();
 	CompilerContext.MovePinLinksToIntermediate(*SpawnNodeThen, *CallThen);
 
@@ -36,7 +36,7 @@ void UEventsK2Node_NotifyEvent::AddInnerPin(FName PinName, const FEdGraphPinType
 void UEventsK2Node_NotifyEvent::ExpandNode(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
 {
 	Super::ExpandNode(CompilerContext, SourceGraph);
-	static const FName FuncName = GET_FUNCTION_NAME_CHECKED(UEventSystemBPLibrary, NotifyEventByKeyVariadic);
+	static const FName FuncName = GET_FUNCTION_NAME_CHECKED(UEventSystemBPLibrary, NotifyEventByKeyVariadicInScope);
 
 	UEventsK2Node_NotifyEvent* SpawnNode = this;
 	UEdGraphPin* SpawnEventExec = GetExecPin();
@@ -60,6 +60,9 @@ void UEventsK2Node_NotifyEvent::ExpandNode(class FKismetCompilerContext& Compile
 	UEdGraphPin* CallSenderPin = CallNotifyFuncNode->FindPinChecked(TEXT("Sender"));
 	bError &= CompilerContext.MovePinLinksToIntermediate(*SpawnSenderPin, *CallSenderPin).CanSafeConnect();
 
+	UEdGraphPin* CallScopePin = CallNotifyFuncNode->FindPinChecked(TEXT("Scope"));
+	CallScopePin->DefaultValue = StaticEnum<EEventScope>()->GetNameStringByValue((int64)Scope);
+
 	UEdGraphPin* CallThen = CallNotifyFuncNode->GetThenPin();
 	bError &= CompilerContext.MovePinLinksToIntermediate(*SpawnNodeThen, *CallThen).CanSafeConnect();
 
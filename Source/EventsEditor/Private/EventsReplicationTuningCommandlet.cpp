@@ -0,0 +1,137 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventsReplicationTuningCommandlet.h"
+#include "EventsManager.h"
+#include "EventsSettings.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEventsReplicationTuning, Log, All);
+
+/** Bits ESSerializeTagNetIndexPacked writes for NetIndex */
+static int32 GetPackedNetIndexBits(FEventNetIndex NetIndex, int32 FirstSegment, int32 MaxBits)
+{
+	if (FirstSegment <= 0 || FirstSegment >= MaxBits)
+	{
+		return MaxBits;
+	}
+	return NetIndex < (1 << FirstSegment) ? FirstSegment + 1 : MaxBits + 1;
+}
+
+UEventsReplicationTuningCommandlet::UEventsReplicationTuningCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UEventsReplicationTuningCommandlet::Main(const FString& Params)
+{
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("Events") / TEXT("ReplicationReport.csv");
+	FParse::Value(*Params, TEXT("Report="), ReportPath);
+	const bool bApply = FParse::Param(*Params, TEXT("Apply"));
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *ReportPath))
+	{
+		UE_LOG(LogEventsReplicationTuning, Error, TEXT("Can't read %s, capture one with Events.WriteReport"), *ReportPath);
+		return 1;
+	}
+
+	// Net indices depend on every tag, so tune against the final tree
+	UEventsManager& Manager = UEventsManager::Get();
+	Manager.DoneAddingNativeTags();
+
+	TArray<TPair<FEventInfo, int64>> Counts;
+	int64 TotalCount = 0;
+	for (const FString& Line : Lines)
+	{
+		FString TagString;
+		FString CountString;
+		if (!Line.Split(TEXT(","), &TagString, &CountString) || !CountString.TrimStartAndEnd().IsNumeric())
+		{
+			continue;
+		}
+
+		const FEventInfo Tag = Manager.RequestEvent(FName(*TagString.TrimStartAndEnd()), false);
+		if (!Tag.IsValid())
+		{
+			UE_LOG(LogEventsReplicationTuning, Warning, TEXT("Skipping %s, it isn't an event anymore"), *TagString);
+			continue;
+		}
+
+		Counts.Emplace(Tag, FCString::Atoi64(*CountString));
+		TotalCount += Counts.Last().Value;
+	}
+
+	if (TotalCount == 0)
+	{
+		UE_LOG(LogEventsReplicationTuning, Error, TEXT("%s has no replicated events"), *ReportPath);
+		return 1;
+	}
+
+	// Most replicated first, ties by name so the output is stable
+	Counts.Sort([](const TPair<FEventInfo, int64>& A, const TPair<FEventInfo, int64>& B)
+	{
+		return A.Value > B.Value || (A.Value == B.Value && A.Key.GetTagName().Compare(B.Key.GetTagName()) < 0);
+	});
+
+	const int32 MaxBits = Manager.NetIndexTrueBitNum;
+
+	int64 CurrentBits = 0;
+	for (const TPair<FEventInfo, int64>& Count : Counts)
+	{
+		CurrentBits += Count.Value * GetPackedNetIndexBits(Manager.GetNetIndexFromTag(Count.Key), Manager.NetIndexFirstBitSegment, MaxBits);
+	}
+
+	// A tag costs Segment + 1 bits if its index fits the first segment and MaxBits + 1 otherwise, so for a given
+	// segment the best order puts the 2^Segment most replicated tags first. No segment at all costs MaxBits per tag
+	int32 BestSegment = MaxBits;
+	int64 BestBits = TotalCount * MaxBits;
+	for (int32 Segment = 1; Segment < MaxBits; ++Segment)
+	{
+		const int32 NumFirst = FMath::Min(1 << Segment, Counts.Num());
+		int64 Bits = 0;
+		for (int32 Rank = 0; Rank < Counts.Num(); ++Rank)
+		{
+			Bits += Counts[Rank].Value * (Rank < NumFirst ? Segment + 1 : MaxBits + 1);
+		}
+
+		if (Bits < BestBits)
+		{
+			BestBits = Bits;
+			BestSegment = Segment;
+		}
+	}
+
+	TArray<FName> CommonTags;
+	if (BestSegment < MaxBits)
+	{
+		for (int32 Rank = 0; Rank < FMath::Min(1 << BestSegment, Counts.Num()); ++Rank)
+		{
+			CommonTags.Add(Counts[Rank].Key.GetTagName());
+		}
+	}
+
+	UE_LOG(LogEventsReplicationTuning, Display, TEXT("%lld replicated events, %d bit net indices"), TotalCount, MaxBits);
+	UE_LOG(LogEventsReplicationTuning, Display, TEXT("Current settings: %lld bits, %.2f per event (NetIndexFirstBitSegment=%d)"), CurrentBits, (double)CurrentBits / TotalCount, Manager.NetIndexFirstBitSegment);
+	UE_LOG(LogEventsReplicationTuning, Display, TEXT("Tuned settings:   %lld bits, %.2f per event (NetIndexFirstBitSegment=%d), %.1f%% saved"), BestBits, (double)BestBits / TotalCount, BestSegment, 100.0 * (CurrentBits - BestBits) / CurrentBits);
+
+	UE_LOG(LogEventsReplicationTuning, Display, TEXT("Suggested config:"));
+	for (FName Tag : CommonTags)
+	{
+		UE_LOG(LogEventsReplicationTuning, Display, TEXT("+CommonlyReplicatedTags=%s"), *Tag.ToString());
+	}
+	UE_LOG(LogEventsReplicationTuning, Display, TEXT("NetIndexFirstBitSegment=%d"), BestSegment);
+
+	if (bApply)
+	{
+		UEventsSettings* Settings = GetMutableDefault<UEventsSettings>();
+		Settings->CommonlyReplicatedTags = CommonTags;
+		Settings->NetIndexFirstBitSegment = BestSegment;
+		Settings->UpdateDefaultConfigFile();
+		UE_LOG(LogEventsReplicationTuning, Display, TEXT("Saved to %s"), *Settings->GetDefaultConfigFilename());
+	}
+	return 0;
+}
@@ -0,0 +1,34 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventsSnapshotCommandlet.h"
+#include "EventsManager.h"
+#include "EventDictionarySnapshot.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEventsSnapshot, Log, All);
+
+UEventsSnapshotCommandlet::UEventsSnapshotCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UEventsSnapshotCommandlet::Main(const FString& Params)
+{
+	FString OutputPath = FEventDictionarySnapshot::GetDefaultFilename();
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	// Late native tags change the tree and the net indices, so the snapshot is taken once they are in
+	UEventsManager& Manager = UEventsManager::Get();
+	Manager.DoneAddingNativeTags();
+
+	if (!FEventDictionarySnapshot::Write(Manager, OutputPath))
+	{
+		UE_LOG(LogEventsSnapshot, Error, TEXT("Can't write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogEventsSnapshot, Display, TEXT("Wrote %d events to %s, net index hash %x"), Manager.GetDictionary()->Num(), *OutputPath, Manager.GetNetworkEventNodeIndexHash());
+	return 0;
+}
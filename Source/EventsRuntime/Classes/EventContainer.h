@@ -11,6 +11,7 @@
 
 class UEditableEventQuery;
 struct FEventContainer;
+struct FEventKey;
 struct FPropertyTag;
 
 EVENTSRUNTIME_API DECLARE_LOG_CATEGORY_EXTERN(LogEvents, Log, All);
@@ -42,6 +43,42 @@ enum class EEventContainerMatchType : uint8
 typedef uint16 FEventNetIndex;
 #define INVALID_TAGNETINDEX MAX_uint16
 
+#define INVALID_EVENTINDEX MAX_uint16
+
+/**
+ * Position of an event in the flat event dictionary, half the size of an FEventInfo and compared as one integer.
+ * Only meaningful for the dictionary it came from, it carries that dictionary's generation and converts back to an
+ * invalid tag once the tree is rebuilt. Convert to FEventInfo before saving or replicating it.
+ */
+struct FEventIndex
+{
+	FEventIndex() {}
+	FEventIndex(uint16 InIndex, uint16 InGeneration) : Index(InIndex), Generation(InGeneration) {}
+
+	FORCEINLINE bool IsValid() const { return Index != INVALID_EVENTINDEX; }
+	FORCEINLINE int32 GetIndex() const { return IsValid() ? Index : INDEX_NONE; }
+	FORCEINLINE uint16 GetGeneration() const { return Generation; }
+
+	FORCEINLINE bool operator==(const FEventIndex& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	FORCEINLINE bool operator!=(const FEventIndex& Other) const { return !operator==(Other); }
+
+	/** Dictionary order, which is depth first tag order */
+	FORCEINLINE bool operator<(const FEventIndex& Other) const { return Index < Other.Index; }
+
+	/** The index and generation as one integer, for storage that is read and written in a single access */
+	FORCEINLINE uint32 Pack() const { return Index | ((uint32)Generation << 16); }
+	static FORCEINLINE FEventIndex Unpack(uint32 Packed) { return FEventIndex((uint16)(Packed & 0xFFFF), (uint16)(Packed >> 16)); }
+
+	FORCEINLINE friend uint32 GetTypeHash(const FEventIndex& EventIndex)
+	{
+		return EventIndex.Pack();
+	}
+
+private:
+	uint16 Index = INVALID_EVENTINDEX;
+	uint16 Generation = 0;
+};
+
 /**
  * A single gameplay tag, which represents a hierarchical name of the form x.y that is registered in the EventsManager
  * You can filter the gameplay tags displayed in the editor using, meta = (Categories = "Tag1.Tag2.Tag3"))
@@ -143,14 +180,23 @@ struct EVENTSRUNTIME_API FEventInfo
 	 */
 	bool MatchesAnyExact(const FEventContainer& ContainerToCheck) const;
 
+	/** Compact index of this tag in the current dictionary, invalid if the tag isn't in it or the dictionary is being rebuilt */
+	FEventIndex GetEventIndex() const;
+
+	/** Tag at EventIndex, invalid if the index came from an older dictionary */
+	static FEventInfo FromEventIndex(FEventIndex EventIndex);
+
+	/** Key event channels know this tag by, found through the dictionary index so the name isn't hashed again */
+	FEventKey GetChannelKey() const;
+
 	/** Returns whether the tag is valid or not; Invalid tags are set to NAME_None and do not exist in the game-specific global dictionary */
 	FORCEINLINE bool IsValid() const
 	{
 		return (TagName != NAME_None);
 	}
 
-	/** Returns reference to a EventContainer containing only this tag */
-	const FEventContainer& GetSingleTagContainer() const;
+	/** Returns a EventContainer containing only this tag, built from the tag's parent chain. Returned by value since nodes no longer own a container */
+	FEventContainer GetSingleTagContainer() const;
 
 	/** Returns direct parent Event of this Event, calling on x.y will return x */
 	FEventInfo RequestDirectParent() const;
@@ -250,9 +296,14 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = Events, SaveGame)
 	FName TagName;
 
+	/** Packed FEventIndex of this tag in the last dictionary it was found in, so matching skips the name lookup. Tags are read on any thread, so it is accessed atomically */
+	mutable int32 CachedEventIndex = (int32)FEventIndex().Pack();
+
 	friend class UEventsManager;
+	friend class FEventDictionary;
 	friend struct FEventContainer;
 	friend struct FEventNode;
+	friend struct FEventNodeView;
 };
 
 template<>
@@ -324,15 +375,10 @@ struct EVENTSRUNTIME_API FEventContainer
 	 * 
 	 * @return True if TagToCheck is in this container, false if it is not
 	 */
-	FORCEINLINE_DEBUGGABLE bool HasTag(const FEventInfo& TagToCheck) const
-	{
-		if (!TagToCheck.IsValid())
-		{
-			return false;
-		}
-		// Check explicit and parent tag list 
-		return Events.Contains(TagToCheck) || ParentTags.Contains(TagToCheck);
-	}
+	bool HasTag(const FEventInfo& TagToCheck) const;
+
+	/** Same as HasTag for the tag at EventIndex, false if the index came from an older dictionary */
+	bool HasTag(FEventIndex EventIndex) const;
 
 	/**
 	 * Determine if TagToCheck is explicitly present in this container, only allowing exact matches
@@ -358,21 +404,7 @@ struct EVENTSRUNTIME_API FEventContainer
 	 *
 	 * @return True if this container has ANY of the tags of in ContainerToCheck
 	 */
-	FORCEINLINE_DEBUGGABLE bool HasAny(const FEventContainer& ContainerToCheck) const
-	{
-		if (ContainerToCheck.IsEmpty())
-		{
-			return false;
-		}
-		for (const FEventInfo& OtherTag : ContainerToCheck.Events)
-		{
-			if (Events.Contains(OtherTag) || ParentTags.Contains(OtherTag))
-			{
-				return true;
-			}
-		}
-		return false;
-	}
+	bool HasAny(const FEventContainer& ContainerToCheck) const;
 
 	/**
 	 * Checks if this container contains ANY of the tags in the specified container, only allowing exact matches
@@ -840,6 +872,7 @@ protected:
 	friend struct FEventQuery;
 	friend struct FEventQueryExpression;
 	friend struct FEventNode;
+	friend struct FEventParentChain;
 	friend struct FEventInfo;
 	
 private:
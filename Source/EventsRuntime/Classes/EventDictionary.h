@@ -0,0 +1,200 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EventContainer.h"
+#include "EventSearchIndex.h"
+#include "Systems/EventSchema.h"
+#include "Systems/EventKey.h"
+
+struct FEventNode;
+class FEventDictionary;
+enum class EEventReplicationPolicy : uint8;
+
+/** What the dictionary declares about an event besides its name, see FEventTableRow */
+struct FEventEntryData
+{
+	TArray<FEventParameterDesc> Parameters;
+	FEventThrottle Throttle;
+	EEventReplicationPolicy Replication;
+};
+
+/**
+ * A published dictionary as loaded by a reader. Published dictionaries are never modified, a replaced one is freed a few frames
+ * after it was retired, so a reader off the game thread must not keep one past the lookup it loaded it for
+ */
+typedef const FEventDictionary* FEventDictionaryPtr;
+
+/** Non owning view of one dictionary entry, only valid as long as its dictionary is */
+struct EVENTSRUNTIME_API FEventNodeView
+{
+	FEventNodeView() {}
+	FEventNodeView(const FEventDictionary* InDictionary, int32 InIndex) : Dictionary(InDictionary), Index(InIndex) {}
+
+	bool IsValid() const { return Dictionary && Index != INDEX_NONE; }
+	int32 GetIndex() const { return Index; }
+
+	FName GetCompleteTagName() const;
+	FName GetSimpleTagName() const;
+	FEventInfo GetCompleteTag() const { return FEventInfo(GetCompleteTagName()); }
+	FEventNodeView GetParent() const;
+	int32 GetDepth() const;
+	FEventNetIndex GetNetIndex() const;
+
+	/** Children are walked through their siblings, prefer GetFirstChild and GetNextSibling of the dictionary in loops */
+	int32 NumChildren() const;
+	FEventNodeView GetChild(int32 ChildIndex) const;
+
+private:
+	const FEventDictionary* Dictionary = nullptr;
+	int32 Index = INDEX_NONE;
+};
+
+/**
+ * Flat copy of the event tree, rebuilt by UEventsManager whenever the tree changes.
+ * Entries are laid out in depth first pre-order as parallel arrays, so walking a subtree or a parent
+ * chain touches a few contiguous arrays instead of chasing shared pointers.
+ * It costs 31 bytes per event next to the tree, plus the name map, the search index and the data of declared events. Child lists are
+ * derived from the pre-order layout rather than stored.
+ */
+class EVENTSRUNTIME_API FEventDictionary
+{
+public:
+	/**
+	 * Flattens every node below Root, Root itself is not part of the dictionary. Generation tags the FEventIndex values it hands out.
+	 * A non empty NetOrder numbers the nodes by their position in it instead of reading their net index, so the tree isn't written.
+	 */
+	void Build(const FEventNode& Root, uint16 InGeneration = 0, TArrayView<const TSharedPtr<FEventNode>> NetOrder = TArrayView<const TSharedPtr<FEventNode>>());
+	void Reset();
+
+	int32 Num() const { return TagNames.Num(); }
+	uint16 GetGeneration() const { return Generation; }
+
+	/** Compact form of Index, invalid past the first INVALID_EVENTINDEX entries */
+	FEventIndex GetEventIndex(int32 Index) const
+	{
+		return Index >= 0 && Index < INVALID_EVENTINDEX ? FEventIndex((uint16)Index, Generation) : FEventIndex();
+	}
+
+	/** Entry of EventIndex, INDEX_NONE if it is invalid or from another generation */
+	int32 Find(FEventIndex EventIndex) const
+	{
+		return EventIndex.GetGeneration() == Generation && EventIndex.GetIndex() < Num() ? EventIndex.GetIndex() : INDEX_NONE;
+	}
+
+	/** Entry of TagName, INDEX_NONE if it isn't in the dictionary */
+	int32 Find(FName TagName) const
+	{
+		const int32* Index = NameToIndex.Find(TagName);
+		return Index ? *Index : INDEX_NONE;
+	}
+
+	/** Entry of Event, read from the index cached on the tag when it came from this dictionary and cached there otherwise */
+	FORCEINLINE int32 Find(const FEventInfo& Event) const
+	{
+		const FEventIndex Cached = FEventIndex::Unpack((uint32)FPlatformAtomics::AtomicRead_Relaxed(&Event.CachedEventIndex));
+		if (Cached.IsValid() && Cached.GetGeneration() == Generation)
+		{
+			return Cached.GetIndex();
+		}
+
+		const int32 Index = Find(Event.TagName);
+		const FEventIndex EventIndex = GetEventIndex(Index);
+		if (EventIndex.IsValid())
+		{
+			FPlatformAtomics::AtomicStore_Relaxed(&Event.CachedEventIndex, (int32)EventIndex.Pack());
+		}
+		return Index;
+	}
+
+	/** Entry replicated as NetIndex, INDEX_NONE if no entry has it */
+	int32 FindByNetIndex(FEventNetIndex NetIndex) const
+	{
+		return NetIndexToEntry.IsValidIndex(NetIndex) ? NetIndexToEntry[NetIndex] : INDEX_NONE;
+	}
+
+	/** Net indices in use, every index below this may be replicated */
+	int32 GetNumNetIndices() const { return NetIndexToEntry.Num(); }
+
+	FEventNodeView GetView(int32 Index) const { return FEventNodeView(this, Index); }
+
+	FName GetTagName(int32 Index) const { return TagNames[Index]; }
+	FName GetSimpleTagName(int32 Index) const { return SimpleNames[Index]; }
+	int32 GetParent(int32 Index) const { return Parents[Index]; }
+	int32 GetDepth(int32 Index) const { return Depths[Index]; }
+	FEventNetIndex GetNetIndex(int32 Index) const { return NetIndices[Index]; }
+
+	/** Key channels use for the event of Index, registered when the dictionary is built */
+	FEventKey GetChannelKey(int32 Index) const { return ChannelKeys[Index]; }
+
+	/** One past the last descendant of Index, the subtree of Index is the entry range [Index, GetSubtreeEnd(Index)) */
+	int32 GetSubtreeEnd(int32 Index) const { return SubtreeEnds[Index]; }
+
+	/** True if Index is Ancestor or one of its descendants, pre-order makes this a range test */
+	bool IsInSubtree(int32 Index, int32 Ancestor) const { return Index >= Ancestor && Index < SubtreeEnds[Ancestor]; }
+
+	/** Every descendant of Index in pre-order, a slice of the dictionary so nothing is copied */
+	TArrayView<const FName> GetDescendantNames(int32 Index) const { return TArrayView<const FName>(TagNames.GetData() + Index + 1, SubtreeEnds[Index] - Index - 1); }
+
+	/** First child of Index in tag order, INDEX_NONE for a leaf. In pre-order it directly follows its parent */
+	int32 GetFirstChild(int32 Index) const { return Index + 1 < SubtreeEnds[Index] ? Index + 1 : INDEX_NONE; }
+
+	/** Next child of the parent of Index, INDEX_NONE for the last one. Siblings are one subtree apart */
+	int32 GetNextSibling(int32 Index) const
+	{
+		const int32 ParentEnd = Parents[Index] != INDEX_NONE ? SubtreeEnds[Parents[Index]] : Num();
+		return SubtreeEnds[Index] < ParentEnd ? SubtreeEnds[Index] : INDEX_NONE;
+	}
+
+	/** Declared parameters, throttle and replication policy of Index */
+	const FEventEntryData& GetEntryData(int32 Index) const;
+
+	/** Name search over the complete tag names */
+	const FEventSearchIndex& GetSearchIndex() const { return SearchIndex; }
+
+private:
+	TArray<FName> TagNames;
+	TArray<FName> SimpleNames;
+	TArray<int32> Parents;
+	TArray<int32> SubtreeEnds;
+	TArray<uint8> Depths;
+	TArray<FEventNetIndex> NetIndices;
+	TArray<FEventKey> ChannelKeys;
+
+	/** Only entries that declare parameters, a throttle or a replication policy other than the default have data */
+	TMap<int32, FEventEntryData> EntryData;
+
+	TMap<FName, int32> NameToIndex;
+	TArray<int32> NetIndexToEntry;
+
+	FEventSearchIndex SearchIndex;
+
+	uint16 Generation = 0;
+};
+
+FORCEINLINE FName FEventNodeView::GetCompleteTagName() const { return IsValid() ? Dictionary->GetTagName(Index) : NAME_None; }
+FORCEINLINE FName FEventNodeView::GetSimpleTagName() const { return IsValid() ? Dictionary->GetSimpleTagName(Index) : NAME_None; }
+FORCEINLINE FEventNodeView FEventNodeView::GetParent() const { return IsValid() ? FEventNodeView(Dictionary, Dictionary->GetParent(Index)) : FEventNodeView(); }
+FORCEINLINE int32 FEventNodeView::GetDepth() const { return IsValid() ? Dictionary->GetDepth(Index) : 0; }
+FORCEINLINE FEventNetIndex FEventNodeView::GetNetIndex() const { return IsValid() ? Dictionary->GetNetIndex(Index) : INVALID_TAGNETINDEX; }
+
+FORCEINLINE int32 FEventNodeView::NumChildren() const
+{
+	int32 Count = 0;
+	for (int32 Child = IsValid() ? Dictionary->GetFirstChild(Index) : INDEX_NONE; Child != INDEX_NONE; Child = Dictionary->GetNextSibling(Child))
+	{
+		++Count;
+	}
+	return Count;
+}
+
+FORCEINLINE FEventNodeView FEventNodeView::GetChild(int32 ChildIndex) const
+{
+	int32 Child = Dictionary->GetFirstChild(Index);
+	for (; ChildIndex > 0 && Child != INDEX_NONE; --ChildIndex)
+	{
+		Child = Dictionary->GetNextSibling(Child);
+	}
+	return FEventNodeView(Dictionary, Child);
+}
@@ -0,0 +1,84 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+
+class UEventsManager;
+
+/**
+ * Binary image of the final event tree, written by the EventsSnapshot commandlet and memory mapped by cooked builds
+ * so startup doesn't have to read the ini files and data tables again.
+ * The file is a header followed by fixed size entry and parameter records, names are offsets into a table of null
+ * terminated UTF-8 strings. Entries are in depth first pre-order, so a parent always comes before its children.
+ * The header carries hashes of the ini files and event tables it was built from. They are checked when cooking and a
+ * stale snapshot is written again, so cooked builds trust the snapshot without reading its sources.
+ */
+class EVENTSRUNTIME_API FEventDictionarySnapshot
+{
+public:
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NumEntries;
+		uint32 NumParameters;
+		uint32 StringBytes;
+		uint32 NetworkHash;
+		uint32 bHasNetIndices;
+
+		/** Hashes of the sources the snapshot was written from, see UEventsManager::GetIniSourceHash and GetEventTableHash */
+		uint32 IniHash;
+		uint32 TableHash;
+		uint32 Reserved;
+	};
+
+	struct FEntry
+	{
+		uint32 SimpleName;
+		uint32 CompleteName;
+		int32 Parent;
+		uint32 FirstParameter;
+		uint16 NumParameters;
+		uint16 NetIndex;
+		float MaxRate;
+		float MinInterval;
+		uint8 bDeliverTrailing;
+		uint8 Replication;
+		uint16 Padding;
+	};
+
+	struct FParameter
+	{
+		uint32 Name;
+		uint32 Type;
+	};
+
+	static const uint32 FileMagic = 0x53445645;
+	static const uint32 FileVersion = 3;
+
+	/** Writes the current dictionary of Manager, fails while the dictionary is being rebuilt */
+	static bool Write(const UEventsManager& Manager, const FString& Filename);
+
+	/** Maps Filename, or reads it when the platform can't map it. Null if the file is missing or doesn't validate */
+	static TUniquePtr<FEventDictionarySnapshot> Open(const FString& Filename);
+
+	/** Loose file under Content, stage the Events directory as non UFS so it can be mapped */
+	static FString GetDefaultFilename();
+
+	const FHeader& GetHeader() const { return *(const FHeader*)Data; }
+	const FEntry* GetEntries() const { return (const FEntry*)(Data + sizeof(FHeader)); }
+	const FParameter* GetParameters() const { return (const FParameter*)(GetEntries() + GetHeader().NumEntries); }
+	const ANSICHAR* GetString(uint32 Offset) const { return (const ANSICHAR*)(GetParameters() + GetHeader().NumParameters) + Offset; }
+
+private:
+	bool Validate() const;
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedData;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+};
@@ -0,0 +1,111 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "EventContainer.h"
+#include "Systems/EventChannel.h"
+#include "EventReplicationComponent.generated.h"
+
+class APlayerController;
+
+/** One replicated notify, the payload is a copy owned by the entry */
+struct FEventNetEntry
+{
+	FEventInfo Event;
+	TWeakObjectPtr<UObject> Sender;
+	FEventPayloadPtr Payload;
+};
+
+/**
+ * Every event a connection sends in one frame.
+ * Events are written as their packed tag net index, payloads are packed property by property with the
+ * net serializer of each parameter and prefixed with their bit count, so a receiver that has no listener
+ * for an event can skip it.
+ */
+USTRUCT()
+struct EVENTSRUNTIME_API FEventNetBatch
+{
+	GENERATED_USTRUCT_BODY()
+
+	TArray<FEventNetEntry> Entries;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FEventNetBatch> : public TStructOpsTypeTraitsBase2<FEventNetBatch>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * Sends events over the network, add it to the player controller class to opt in.
+ * Events are queued and flushed once per frame as a single reliable RPC per connection,
+ * the receiving side notifies them in the game instance channel.
+ * Only events whose replication policy allows the sending side are sent and delivered.
+ */
+UCLASS(ClassGroup = Events, meta = (BlueprintSpawnableComponent))
+class EVENTSRUNTIME_API UEventReplicationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UEventReplicationComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	static UEventReplicationComponent* Get(const APlayerController* PlayerController);
+
+	/** Sends from the owning client to the server */
+	void SendToServerWithParams(const FEventInfo& Event, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	/** Sends from the server to the owning client */
+	void SendToClientWithParams(const FEventInfo& Event, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	/** Sends from the server to every player controller of the world that has the component */
+	static void MulticastWithParams(const UObject* WorldContext, const FEventInfo& Event, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	template<typename... TArgs>
+	void SendToServer(const FEventInfo& Event, UObject* Sender, TArgs&&... Args)
+	{
+		TArray<FOutputParam, TInlineAllocator<8>> Params = { MakeOutputParam(Args)... };
+		SendToServerWithParams(Event, Sender, Params);
+	}
+
+	template<typename... TArgs>
+	void SendToClient(const FEventInfo& Event, UObject* Sender, TArgs&&... Args)
+	{
+		TArray<FOutputParam, TInlineAllocator<8>> Params = { MakeOutputParam(Args)... };
+		SendToClientWithParams(Event, Sender, Params);
+	}
+
+	template<typename... TArgs>
+	static void Multicast(const UObject* WorldContext, const FEventInfo& Event, UObject* Sender, TArgs&&... Args)
+	{
+		TArray<FOutputParam, TInlineAllocator<8>> Params = { MakeOutputParam(Args)... };
+		MulticastWithParams(WorldContext, Event, Sender, Params);
+	}
+
+protected:
+	UFUNCTION(Server, Reliable)
+	void ServerReceiveEvents(const FEventNetBatch& Batch);
+
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveEvents(const FEventNetBatch& Batch);
+
+private:
+	/** Copies Params laid out like the local listeners of Event, or like their own properties when nobody listens here */
+	static FEventPayloadPtr CopyPayload(const UObject* WorldContext, const FEventInfo& Event, const TArray<FOutputParam, TInlineAllocator<8>>& Params);
+
+	void Enqueue(FEventNetBatch& Batch, const FEventInfo& Event, UObject* Sender, const FEventPayloadPtr& Payload);
+	/** Notifies the entries of Batch that the replication policy of their event lets the sending side send */
+	void Deliver(const FEventNetBatch& Batch, bool bFromClient);
+
+	FEventNetBatch PendingToServer;
+	FEventNetBatch PendingToClient;
+};
@@ -0,0 +1,51 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EEventSearchMode : uint8
+{
+	/** Names starting with the query */
+	Prefix,
+	/** Names containing the query */
+	Substring,
+	/** Names sharing the most three character runs with the query, tolerates typos and reordered parts */
+	Fuzzy,
+};
+
+/**
+ * Case insensitive name search over the dictionary entries, built together with FEventDictionary.
+ * Prefix queries binary search a sorted copy of the names, substring and fuzzy queries intersect or count the
+ * posting lists of the query's trigrams, so neither has to walk every name.
+ */
+class EVENTSRUNTIME_API FEventSearchIndex
+{
+public:
+	void Build(TArrayView<const FName> Names);
+	void Reset();
+
+	/** Entries matching Query. Prefix and substring results are in entry order, fuzzy results best match first. 0 MaxResults means no cap */
+	void Search(const FString& Query, EEventSearchMode Mode, TArray<int32>& OutEntries, int32 MaxResults = 0) const;
+
+private:
+	const TCHAR* GetText(int32 Entry) const { return Text.GetData() + TextStart[Entry]; }
+	int32 GetTextLen(int32 Entry) const { return TextStart[Entry + 1] - TextStart[Entry] - 1; }
+
+	/** Sorted entries of every trigram, empty if none has it */
+	TArrayView<const int32> GetPostings(uint64 Trigram) const;
+
+	/** Unique trigrams of a lower case string, sorted */
+	static void GetTrigrams(const TCHAR* String, int32 Len, TArray<uint64, TInlineAllocator<64>>& OutTrigrams);
+
+	/** Lower case names, null terminated back to back. TextStart has one extra element marking the end */
+	TArray<TCHAR> Text;
+	TArray<int32> TextStart;
+
+	/** Entries sorted by lower case name, for prefix queries */
+	TArray<int32> SortedEntries;
+
+	/** Posting lists, the entries of a trigram are the Value.Value elements of Postings starting at Value.Key */
+	TMap<uint64, TPair<int32, int32>> TrigramRanges;
+	TArray<int32> Postings;
+};
@@ -4,16 +4,22 @@
 
 #include "CoreMinimal.h"
 #include "Stats/Stats.h"
+#include "Templates/Atomic.h"
+#include "Async/Future.h"
 #include "UObject/ObjectMacros.h"
 #include "UObject/Object.h"
 #include "UObject/ScriptMacros.h"
 #include "EventContainer.h"
+#include "EventDictionary.h"
+#include "EventDictionarySnapshot.h"
 #include "Engine/DataTable.h"
+#include "Systems/EventSchema.h"
 
 #include "EventsManager.generated.h"
 
 class UEventsList;
 struct FStreamableHandle;
+struct FEventRedirect;
 
 
 USTRUCT(BlueprintInternalUseOnly)
@@ -27,6 +33,18 @@ public:
 		FName Type;
 };
 
+/** Which side of a connection may send an event to the other */
+UENUM()
+enum class EEventReplicationPolicy : uint8
+{
+	/** Only the server sends the event, to its clients */
+	ServerToClient,
+	/** Only clients send the event, to the server */
+	ClientToServer,
+	/** Both sides may send the event */
+	Both,
+};
+
 /** Simple struct for a table row in the gameplay tag table and element in the ini list */
 USTRUCT()
 struct FEventTableRow : public FTableRowBase
@@ -44,6 +62,14 @@ struct FEventTableRow : public FTableRowBase
 	UPROPERTY(EditAnywhere, Category = Event)
 	TArray<FEventParameter> Parameters;
 
+	/** Limits how often the event reaches its listeners */
+	UPROPERTY(EditAnywhere, Category = Event)
+	FEventThrottle Throttle;
+
+	/** Who may send the event over the network, the server drops client events that aren't allowed to come from clients */
+	UPROPERTY(EditAnywhere, Category = Event)
+	EEventReplicationPolicy Replication = EEventReplicationPolicy::ServerToClient;
+
 	/** Constructors */
 	FEventTableRow() {}
 	FEventTableRow(FName InTag, const FString& InDevComment = TEXT(""), const TArray<FEventParameter>& InParameters = {}) :
@@ -157,6 +183,8 @@ struct FEventSource
 #endif
 };
 
+struct FEventParentChain;
+
 /** Simple tree node for gameplay tags, this stores metadata about specific tags */
 USTRUCT()
 struct FEventNode
@@ -167,15 +195,15 @@ struct FEventNode
 	/** Simple constructor, passing redundant data for performance */
 	FEventNode(FName InTag, FName InFullTag, TSharedPtr<FEventNode> InParentNode, bool InIsExplicitTag, bool InIsRestrictedTag, bool InAllowNonRestrictedChildren);
 
-	/** Returns a correctly constructed container with only this tag, useful for doing container queries */
-	FORCEINLINE const FEventContainer& GetSingleTagContainer() const { return CompleteTagWithParents; }
+	/** Returns this tag and its parents, useful for doing container queries */
+	FORCEINLINE FEventParentChain GetSingleTagContainer() const;
 
 	/**
 	 * Get the complete tag for the node, including all parent tags, delimited by periods
 	 * 
 	 * @return Complete tag for the node
 	 */
-	FORCEINLINE const FEventInfo& GetCompleteTag() const { return CompleteTagWithParents.Num() > 0 ? CompleteTagWithParents.Events[0] : FEventInfo::EmptyTag; }
+	FORCEINLINE const FEventInfo& GetCompleteTag() const { return CompleteTag; }
 	FORCEINLINE FName GetCompleteTagName() const { return GetCompleteTag().GetTagName(); }
 	FORCEINLINE FString GetCompleteTagString() const { return GetCompleteTag().ToString(); }
 
@@ -241,12 +269,14 @@ struct FEventNode
 		return true;
 	}
 	TArray<FEventParameter> Parameters;
+	FEventThrottle Throttle;
+	EEventReplicationPolicy Replication = EEventReplicationPolicy::ServerToClient;
 private:
 	/** Raw name for this tag at current rank in the tree */
 	FName Tag;
 
-	/** This complete tag is at Events[0], with parents in ParentTags[] */
-	FEventContainer CompleteTagWithParents;
+	/** Complete tag including all parents, the parents themselves are found through ParentNode */
+	FEventInfo CompleteTag;
 
 	/** Child gameplay tag nodes */
 	TArray< TSharedPtr<FEventNode> > ChildTags;
@@ -285,6 +315,117 @@ private:
 
 	friend class UEventsManager;
 	friend class SEventWidget;
+	friend struct FEventParentChain;
+};
+
+/**
+ * Non owning view of a tag followed by its parents, nearest parent first. Walks the parent entries of a dictionary,
+ * or the parent links of the tree while there is no dictionary to read, and is valid as long as what it walks is
+ */
+struct EVENTSRUNTIME_API FEventParentChain
+{
+	/** Iterates a node or dictionary entry and its ancestors, stopping below the root */
+	struct FConstIterator
+	{
+		FConstIterator(const FEventNode* InNode, FEventNodeView InView) : Node(InNode), View(InView) {}
+
+		FORCEINLINE FEventInfo operator*() const { return Node ? Node->GetCompleteTag() : View.GetCompleteTag(); }
+		FORCEINLINE FConstIterator& operator++()
+		{
+			if (Node)
+			{
+				Node = GetParent(Node);
+			}
+			else
+			{
+				View = View.GetParent();
+			}
+			return *this;
+		}
+		FORCEINLINE bool operator!=(const FConstIterator& Other) const { return Node != Other.Node || View.GetIndex() != Other.View.GetIndex(); }
+
+	private:
+		const FEventNode* Node;
+		FEventNodeView View;
+	};
+
+	/** Range over a tag and its ancestors, for range based for loops */
+	struct FRange
+	{
+		FRange(const FEventNode* InNode, FEventNodeView InView) : Node(InNode), View(InView) {}
+
+		FORCEINLINE FConstIterator begin() const { return FConstIterator(Node, View); }
+		FORCEINLINE FConstIterator end() const { return FConstIterator(nullptr, FEventNodeView()); }
+
+	private:
+		const FEventNode* Node;
+		FEventNodeView View;
+	};
+
+	FEventParentChain() {}
+	explicit FEventParentChain(const FEventNode* InNode) : Node(InNode) {}
+	explicit FEventParentChain(FEventNodeView InView) : View(InView) {}
+
+	FORCEINLINE bool IsValid() const { return Node != nullptr || View.IsValid(); }
+	FORCEINLINE FEventInfo GetTag() const { return Node ? Node->GetCompleteTag() : View.GetCompleteTag(); }
+	FORCEINLINE FRange GetTags() const { return FRange(Node, View); }
+	FORCEINLINE FRange GetParents() const { return Node ? FRange(GetParent(Node), FEventNodeView()) : FRange(nullptr, View.GetParent()); }
+
+	/** The topmost tag of the chain, the last one GetTags visits */
+	FEventInfo GetRoot() const;
+
+	/** Same as HasTag on the single tag container, true if TagToCheck is the tag or one of its parents */
+	bool HasTag(const FEventInfo& TagToCheck) const;
+
+	/** Same as HasAny on the single tag container */
+	bool HasAny(const FEventContainer& ContainerToCheck) const;
+
+	/** Owning single tag container, the tag as its explicit tag and the parents as its parent tags */
+	FEventContainer ToContainer() const;
+
+private:
+	/** The next node up the chain, null past the last real tag */
+	static FORCEINLINE const FEventNode* GetParent(const FEventNode* InNode)
+	{
+		const FEventNode* Parent = InNode->ParentNode.Get();
+		return Parent && Parent->Tag != NAME_None ? Parent : nullptr;
+	}
+
+	const FEventNode* Node = nullptr;
+	FEventNodeView View;
+};
+
+FORCEINLINE FEventParentChain FEventNode::GetSingleTagContainer() const
+{
+	return FEventParentChain(this);
+}
+
+/** Tag row split into its sub tags, prepared by worker tasks before the row is inserted into the tree */
+struct FEventTableRowSplit
+{
+	const FEventTableRow* Row = nullptr;
+
+	/** Simple and complete name of every level of the tag, root first */
+	TArray<FName, TInlineAllocator<8>> SimpleNames;
+	TArray<FName, TInlineAllocator<8>> CompleteNames;
+};
+
+/** What one incremental update changed in the event tree, broadcast by IEventsModule::OnEventTreeDelta */
+struct FEventTreeDelta
+{
+	/** Tags that were created, parents before children */
+	TArray<FName> Added;
+
+	/** Tags that were removed, children before parents */
+	TArray<FName> Removed;
+
+	/** Old and new name of every renamed tag, the old name keeps resolving through a redirect */
+	TArray<TPair<FName, FName>> Renamed;
+
+	/** Lowest net index that moved, INDEX_NONE if every net index stayed the same */
+	int32 FirstChangedNetIndex = INDEX_NONE;
+
+	bool IsEmpty() const { return Added.Num() == 0 && Removed.Num() == 0 && Renamed.Num() == 0; }
 };
 
 /** Holds data about the tag dictionary, is in a singleton UObject */
@@ -345,6 +486,9 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 	 */
 	FEventInfo FindEventFromPartialString_Slow(FString PartialString) const;
 
+	/** Case insensitive search of the dictionary's name index, fast enough to run on every keystroke. Empty while native tags are still being added */
+	void SearchEvents(const FString& Query, EEventSearchMode Mode, TArray<FEventInfo>& OutEvents, int32 MaxResults = 0) const;
+
 	/**
 	 * Registers the given name as a gameplay tag, and tracks that it is being directly referenced from code
 	 * This can only be called during engine initialization, the table needs to be locked down before replication
@@ -382,26 +526,50 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 	 */
 	FEventContainer RequestEventChildren(const FEventInfo& Event) const;
 
+	/**
+	 * Names of every tag below Event in depth first order, without building a container.
+	 * Empty while the dictionary is being rebuilt
+	 */
+	TArray<FName> RequestEventDescendantNames(const FEventInfo& Event) const;
+
+	/** Compact index of Event in the current dictionary, invalid while the dictionary is being rebuilt */
+	FEventIndex GetEventIndex(const FEventInfo& Event) const;
+
+	/** Event at EventIndex, invalid if the index came from an older dictionary */
+	FEventInfo GetEventFromIndex(FEventIndex EventIndex) const;
+
+	/** MatchesTag for indices, true if EventIndex is IndexToCheck or below it */
+	bool EventIndexMatches(FEventIndex EventIndex, FEventIndex IndexToCheck) const;
+
 	/** Returns direct parent Event of this Event, calling on x.y will return x */
 	FEventInfo RequestEventDirectParent(const FEventInfo& Event) const;
 
 	/**
-	 * Helper function to get the stored TagContainer containing only this tag, which has searchable ParentTags
+	 * Helper function to get the stored chain of this tag and its parents, which has searchable parent tags
 	 * @param Event		Tag to get single container of
-	 * @return					Pointer to container with this tag
+	 * @return					View of the tag and its parents, invalid if the tag isn't in the dictionary or the tree
 	 */
-	FORCEINLINE_DEBUGGABLE const FEventContainer* GetSingleTagContainer(const FEventInfo& Event) const
+	FORCEINLINE_DEBUGGABLE FEventParentChain GetSingleTagContainer(const FEventInfo& Event) const
 	{
+		FEventDictionaryPtr FlatDictionary;
+		const FEventNodeView View = FindTagView(Event, FlatDictionary);
+		if (View.IsValid())
+		{
+			return FEventParentChain(View);
+		}
+
+		// Redirected names are only resolved by the tree
 		TSharedPtr<FEventNode> TagNode = FindTagNode(Event);
 		if (TagNode.IsValid())
 		{
-			return &(TagNode->GetSingleTagContainer());
+			return TagNode->GetSingleTagContainer();
 		}
-		return nullptr;
+		return FEventParentChain();
 	}
 
 	/**
-	 * Checks node tree to see if a FEventNode with the tag exists
+	 * Checks node tree to see if a FEventNode with the tag exists.
+	 * Cooked builds release the tree once the events are final, read the dictionary rather than the nodes
 	 *
 	 * @param TagName	The name of the tag node to search for
 	 *
@@ -447,9 +615,28 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 		return FindTagNode(PossibleTag);
 	}
 
-	/** Loads the tag tables referenced in the EventSettings object */
+	/**
+	 * Flat copy of the tree, null until the first one is published. Off the game thread this is a single load of the published pointer,
+	 * the game thread gets null while its own changes to the tree aren't flattened yet so it reads the tree instead
+	 */
+	FORCEINLINE FEventDictionaryPtr GetDictionary() const
+	{
+		if (bDictionaryDirty.Load(EMemoryOrder::Relaxed) && IsInGameThread())
+		{
+			return nullptr;
+		}
+		return PublishedDictionary.Load();
+	}
+
+	/** Loads the tag tables referenced in the EventSettings object. Cooked builds load them asynchronously if allowed */
 	void LoadEventTables(bool bAllowAsyncLoad = false);
 
+	/** True once the tag tables are part of the tree. Until then tags from the tables can't be requested */
+	bool AreEventTablesReady() const { return bEventTablesReady; }
+
+	/** Calls Delegate now if the tag tables are ready, otherwise when the last async table load is added to the tree */
+	void CallOrRegister_OnEventTablesReady(FSimpleMulticastDelegate::FDelegate Delegate);
+
 	/** Loads tag inis contained in the specified path */
 	void AddTagIniSearchPath(const FString& RootDir);
 
@@ -459,6 +646,18 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 	/** Helper function to destroy the gameplay tag tree */
 	void DestroyEventTree();
 
+	/**
+	 * Adds one row without rebuilding the tree, only the new nodes and the net indices after them are touched.
+	 * Restricted rows must be FRestrictedEventTableRow. Returns false if the row is invalid.
+	 */
+	bool AddEventIncremental(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag = false);
+
+	/** Removes a tag and the implicit parents that only existed for it. A tag with children only stops being explicit */
+	bool RemoveEventIncremental(FName TagName);
+
+	/** Renames a leaf tag and redirects the old name to it. Returns false for tags with children, they need a full refresh */
+	bool RenameEventIncremental(FName OldTagName, FName NewTagName);
+
 	/** Splits a tag such as x.y.z into an array of names {x,y,z} */
 	void SplitEventFName(const FEventInfo& Tag, TArray<FName>& OutNames) const;
 
@@ -505,6 +704,12 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 	/** Returns the hash of NetworkEventNodeIndex */
 	uint32 GetNetworkEventNodeIndexHash() const {	return NetworkEventNodeIndexHash;	}
 
+	/** Hash of the ini files that declare events and of the configured table list. Reads every file, only used when writing or cooking the snapshot */
+	uint32 GetIniSourceHash() const;
+
+	/** Hash of the rows of the loaded event tables, only used when writing or cooking the snapshot */
+	uint32 GetEventTableHash() const;
+
 	/** Returns a list of the ini files that contain restricted tags */
 	void GetRestrictedTagConfigFiles(TArray<FString>& RestrictedConfigFiles) const;
 
@@ -545,6 +750,7 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 	/** This is the actual value for an invalid tag "None". This is computed at runtime as (Total number of tags) + 1 */
 	FEventNetIndex InvalidTagNetIndex;
 
+	/** Nodes in net index order, empty in cooked builds once the tree is released. GetTagNameFromNetIndex works either way */
 	const TArray<TSharedPtr<FEventNode>>& GetNetworkEventNodeIndex() const { return NetworkEventNodeIndex; }
 
 	bool IsNativelyAddedTag(FEventInfo Tag) const;
@@ -632,12 +838,24 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 		}
 		else
 		{
-			// Convert both to their containers and do that match
-			const FEventContainer* ContainerOne = GetSingleTagContainer(EventOne);
-			const FEventContainer* ContainerTwo = GetSingleTagContainer(EventTwo);
-			if (ContainerOne && ContainerTwo)
+			// Same result as matching the two single tag containers, read straight from the parent chains
+			const FEventParentChain ChainOne = GetSingleTagContainer(EventOne);
+			const FEventParentChain ChainTwo = GetSingleTagContainer(EventTwo);
+			if (ChainOne.IsValid() && ChainTwo.IsValid())
 			{
-				bResult = ContainerOne->DoesTagContainerMatch(*ContainerTwo, MatchTypeOne, MatchTypeTwo, EEventContainerMatchType::Any);
+				if (MatchTypeTwo == EEventMatchType::Explicit)
+				{
+					bResult = ChainOne.HasTag(EventTwo);
+				}
+				else if (MatchTypeOne == EEventMatchType::Explicit)
+				{
+					bResult = ChainTwo.HasTag(EventOne);
+				}
+				else
+				{
+					// Any shared ancestor means a shared root, the last entry of each chain
+					bResult = ChainOne.GetRoot() == ChainTwo.GetRoot();
+				}
 			}
 		}
 		return bResult;
@@ -651,6 +869,9 @@ class EVENTSRUNTIME_API UEventsManager : public UObject
 	void PrintReplicationFrequencyReport();
 	void NotifyTagReplicated(FEventInfo Tag, bool WasInContainer);
 
+	/** Saves ReplicationCountMap as Tag,Count lines, the input of the EventsReplicationTuning commandlet */
+	bool WriteReplicationFrequencyReport(const FString& Filename) const;
+
 	TMap<FEventInfo, int32>	ReplicationCountMap;
 	TMap<FEventInfo, int32>	ReplicationCountMap_SingleTags;
 	TMap<FEventInfo, int32>	ReplicationCountMap_Containers;
@@ -664,6 +885,9 @@ private:
 	/** finished loading/adding native tags */
 	static FSimpleMulticastDelegate& OnDoneAddingNativeTagsDelegate();
 
+	/** tag tables finished loading and were added to the tree */
+	static FSimpleMulticastDelegate& OnEventTablesReadyDelegate();
+
 	/** The Tag Manager singleton */
 	static UEventsManager* SingletonManager;
 
@@ -673,6 +897,8 @@ private:
 	friend class FEventsEditorModule;
 	friend class UEventsSettings;
 	friend class SAddNewEventSourceWidget;
+	friend class FEventsTreeBulkInsertTest;
+	friend class FEventsNetIndexDeterminismTest;
 
 	/**
 	 * Helper function to insert a tag into a tag node array
@@ -687,15 +913,27 @@ private:
 	 * @param bIsRestrictedTag				Is the tag a restricted tag or a regular gameplay tag
 	 * @param bAllowNonRestrictedChildren	If the tag is a restricted tag, can it have regular gameplay tag children or should all of its children be restricted tags as well?
 	 *
-	 * @return Index of the node of the tag
+	 * @return Node of the tag
 	 */
-	int32 InsertTagIntoNodeArray(FName Tag, FName FullTag, TSharedPtr<FEventNode> ParentNode, TArray< TSharedPtr<FEventNode> >& NodeArray, FName SourceName, const FEventTableRow& TagRow, const FString& DevComment, bool bIsExplicitTag, bool bIsRestrictedTag, bool bAllowNonRestrictedChildren);
+	TSharedPtr<FEventNode> InsertTagIntoNodeArray(FName Tag, FName FullTag, TSharedPtr<FEventNode> ParentNode, TArray< TSharedPtr<FEventNode> >& NodeArray, FName SourceName, const FEventTableRow& TagRow, const FString& DevComment, bool bIsExplicitTag, bool bIsRestrictedTag, bool bAllowNonRestrictedChildren);
 
 	/** Helper function to populate the tag tree from each table */
 	void PopulateTreeFromDataTable(class UDataTable* Table);
 
 	void AddTagTableRow(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag = false);
 
+	/** Adds every row of one source, the rows are split in parallel and inserted in their original order */
+	void AddTagTableRows(TArrayView<const FEventTableRow* const> TagRows, FName SourceName, bool bIsRestrictedTag = false);
+
+	/** Validates and splits a row, safe to call from worker threads. Returns false if the row can't be added */
+	bool SplitTagTableRow(const FEventTableRow& TagRow, FName SourceName, FEventTableRowSplit& OutSplit);
+
+	/** Inserts a split row into the tree, game thread only */
+	void AddSplitTagTableRow(const FEventTableRowSplit& Split, FName SourceName, bool bIsRestrictedTag);
+
+	/** Sorts the children of every node that got new children while bDeferChildSort was set */
+	void SortDeferredChildren();
+
 	void AddChildrenTags(FEventContainer& TagContainer, TSharedPtr<FEventNode> EventNode, bool RecurseAll=true, bool OnlyIncludeDictionaryTags=false) const;
 
 	void AddTagsFromAdditionalLooseIniFiles(const TArray<FString>& IniFileList);
@@ -712,9 +950,81 @@ private:
 	/** Returns the tag source for a given tag source name, or null if not found */
 	FEventSource* FindOrAddTagSource(FName TagSourceName, EEventSourceType SourceType);
 
+	/** Fills CommonlyReplicatedTags from the settings, skipping tags that aren't in the tree */
+	void ResolveCommonlyReplicatedTags();
+
 	/** Constructs the net indices for each tag */
 	void ConstructNetIndex();
 
+	/** Fills OutOrder with every node in net index order, the common tags first and the rest sorted by name. Only reads the tree */
+	void GatherNetIndexOrder(TArray<TSharedPtr<FEventNode>>& OutOrder, int32& OutNumCommon) const;
+
+	/** Stores an async loaded tag table in its slot, the last one to arrive adds them all to the tree */
+	void OnEventTablePackageLoaded(const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result, int32 TableIndex);
+
+	/** Adds the async loaded tables to the constructed tree and publishes it */
+	void FinishAsyncEventTableLoad();
+
+	void SetEventTablesReady();
+
+	/** Resolves every redirect chain to its final tag in TagRedirects, logging cycles and targets that don't exist */
+	void CompileTagRedirects(const TArray<FEventRedirect>& Redirects);
+
+	/** Numbers NetworkEventNodeIndex from FirstIndex on and recomputes the bit counts and the hash */
+	void AssignNetIndices(int32 FirstIndex);
+
+	/** Part of NetworkEventNodeIndex after the common tags, kept sorted by complete name */
+	TArrayView<TSharedPtr<FEventNode>> GetSortedNetIndexRange()
+	{
+		return TArrayView<TSharedPtr<FEventNode>>(NetworkEventNodeIndex.GetData() + NumCommonNetIndices, NetworkEventNodeIndex.Num() - NumCommonNetIndices);
+	}
+
+	/** Adds the nodes a row creates to the tree, without flattening or broadcasting */
+	void AddRowNodes(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag, FEventTreeDelta& Delta, TArray<TSharedPtr<FEventNode>>& OutAdded);
+
+	/** Removes a childless node and its implicit parents that become childless, without flattening or broadcasting */
+	void RemoveLeafNodes(TSharedPtr<FEventNode> Node, FEventTreeDelta& Delta, TArray<TSharedPtr<FEventNode>>& OutRemoved);
+
+	/** Moves the net indices of the added and removed nodes, flattens the dictionary and broadcasts the delta */
+	void FinishIncrementalUpdate(const TArray<TSharedPtr<FEventNode>>& AddedNodes, const TArray<TSharedPtr<FEventNode>>& RemovedNodes, FEventTreeDelta& Delta);
+
+	/** Flattens the tree into a new dictionary and publishes it, call after the tree and its net indices are final */
+	void RebuildDictionary();
+
+	/** Makes NewDictionary the one readers get and retires the previous one */
+	void PublishDictionary(const FEventDictionary* NewDictionary);
+
+	/** Numbers and flattens the tree on a worker once new native tags or table rows are in, the game thread publishes the result */
+	void StartAsyncTreeBuild();
+
+	/** Publishes the result of StartAsyncTreeBuild, waiting for the worker if it isn't done. Called before anything changes the tree */
+	void FinishAsyncTreeBuild();
+
+	/** Finishes a pending tree build and brings back a released tree, called before anything changes the tree */
+	void EnsureEventTree();
+
+	/** Cooked builds drop the tree once the final dictionary is published, every lookup reads the dictionary from then on */
+	void ReleaseEventTree();
+
+	/** Rebuilds a released tree from the published dictionary, which holds the same tree in pre-order */
+	void RestoreEventTree();
+
+	/** Frees the retired dictionaries no reader can still be using, keeps ticking while some are left */
+	bool ReclaimRetiredDictionaries(float DeltaTime);
+
+	/** View of the dictionary entry of Event, invalid if it isn't in the dictionary or the dictionary is out of date */
+	FORCEINLINE FEventNodeView FindTagView(const FEventInfo& Event, FEventDictionaryPtr& OutDictionary) const
+	{
+		OutDictionary = GetDictionary();
+		return OutDictionary ? OutDictionary->GetView(OutDictionary->Find(Event.GetTagName())) : FEventNodeView();
+	}
+
+	/** Snapshot written by the EventsSnapshot commandlet, only used by cooked builds. Opened on first use */
+	const FEventDictionarySnapshot* GetCookedSnapshot();
+
+	/** Builds the tree straight from the cooked snapshot. Returns false if there is none */
+	bool ConstructFromCookedSnapshot();
+
 	/** Marks all of the nodes that descend from CurNode as having an ancestor node that has a source conflict. */
 	void MarkChildrenOfNodeConflict(TSharedPtr<FEventNode> CurNode);
 
@@ -724,9 +1034,42 @@ private:
 	/** Map of Tags to Nodes - Internal use only. FEventBase is inside node structure, do not use FindKey! */
 	TMap<FEventInfo, TSharedPtr<FEventNode>> EventNodeMap;
 
+	/**
+	 * Flat copy of the tree used by lookups, the tree stays for the editor which edits it in place.
+	 * A published dictionary is never modified. Readers on any thread load the pointer without a lock,
+	 * a replaced dictionary is retired and only freed once DictionaryGraceFrames frames have passed.
+	 */
+	TAtomic<const FEventDictionary*> PublishedDictionary { nullptr };
+
+	/** A replaced dictionary and the frame it was replaced on */
+	struct FRetiredDictionary
+	{
+		const FEventDictionary* Dictionary;
+		uint64 RetiredFrame;
+	};
+
+	/** Replaced dictionaries readers on other threads may still be reading, game thread only */
+	TArray<FRetiredDictionary> RetiredDictionaries;
+	FDelegateHandle ReclaimTickHandle;
+
+	/** Frames a replaced dictionary is kept, far longer than any single lookup off the game thread takes */
+	static const uint64 DictionaryGraceFrames = 3;
+
+	/** Bumped for every published dictionary so FEventIndex values from older ones are rejected */
+	uint16 DictionaryGeneration = 0;
+
+	/** Set when the tree changes after the last flatten, lookups on the game thread read the tree until the next rebuild */
+	TAtomic<bool> bDictionaryDirty { true };
+
+	TUniquePtr<FEventDictionarySnapshot> CookedSnapshot;
+	bool bCookedSnapshotOpened = false;
+
 	/** Our aggregated, sorted list of commonly replicated tags. These tags are given lower indices to ensure they replicate in the first bit segment. */
 	TArray<FEventInfo> CommonlyReplicatedTags;
 
+	/** Number of common tags leading NetworkEventNodeIndex, the sorted range starts after them */
+	int32 NumCommonNetIndices = 0;
+
 	/** List of gameplay tag sources */
 	UPROPERTY()
 	TArray<FEventSource> TagSources;
@@ -740,6 +1083,10 @@ private:
 
 	bool bIsConstructingEventTree = false;
 
+	/** Set while AddTagTableRows inserts a source, new children are appended and their siblings sorted once at the end */
+	bool bDeferChildSort = false;
+	TSet<FEventNode*> UnsortedParents;
+
 	/** Cached runtime value for whether we are using fast replication or not. Initialized from config setting. */
 	bool bUseFastReplication;
 
@@ -749,6 +1096,21 @@ private:
 	/** True if native tags have all been added and flushed */
 	bool bDoneAddingNativeTags;
 
+	/** True once the tree with every native tag and table row is published and OnDoneAddingNativeTagsDelegate has been broadcast */
+	bool bNativeTagTreeReady = false;
+
+	/** Set while the tree is dropped in favor of the published dictionary, see ReleaseEventTree */
+	bool bEventTreeReleased = false;
+
+	/** Net order and dictionary built by the worker StartAsyncTreeBuild starts */
+	struct FAsyncTreeBuild
+	{
+		TArray<TSharedPtr<FEventNode>> NetOrder;
+		int32 NumCommon = 0;
+		TUniquePtr<FEventDictionary> Dictionary;
+	};
+	TFuture<FAsyncTreeBuild*> AsyncTreeBuild;
+
 	/** String with outlawed characters inside tags */
 	FString InvalidTagCharacters;
 
@@ -770,7 +1132,12 @@ private:
 	UPROPERTY()
 	TArray<UDataTable*> EventTables;
 
-	/** The map of ini-configured tag redirectors */
+	/** Tag tables still being async loaded */
+	int32 PendingEventTableLoads = 0;
+
+	bool bEventTablesReady = false;
+
+	/** The map of ini-configured tag redirectors, flattened so every old name maps straight to its final tag */
 	TMap<FName, FEventInfo> TagRedirects;
 
 	const static FName NAME_Categories;
@@ -10,6 +10,7 @@
 #include "EventsManager.h"
 #include "EventsRuntimeModule.h"
 #include "Misc/OutputDeviceNull.h"
+#include "Misc/Paths.h"
 
 const FEventInfo FEventInfo::EmptyTag;
 const FEventContainer FEventContainer::EmptyContainer;
@@ -537,6 +538,96 @@ bool FEventContainer::operator!=(FEventContainer const& Other) const
 	return !operator==(Other);
 }
 
+/**
+ * True if one of Tags lies in the pre-order range of EntryToCheck, the entries of the tags come from the indices cached on them.
+ * bOutAllFound is cleared if some tag isn't in Dictionary, a false result then has to be confirmed from the parent tags
+ */
+static bool ContainsSubtreeOf(const FEventDictionary& Dictionary, const TArray<FEventInfo>& Tags, int32 EntryToCheck, bool& bOutAllFound)
+{
+	for (const FEventInfo& Tag : Tags)
+	{
+		const int32 Entry = Dictionary.Find(Tag);
+		if (Entry == INDEX_NONE)
+		{
+			bOutAllFound = false;
+		}
+		else if (Dictionary.IsInSubtree(Entry, EntryToCheck))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FEventContainer::HasTag(const FEventInfo& TagToCheck) const
+{
+	if (!TagToCheck.IsValid())
+	{
+		return false;
+	}
+
+	if (const FEventDictionaryPtr FlatDictionary = UEventsManager::Get().GetDictionary())
+	{
+		const int32 EntryToCheck = FlatDictionary->Find(TagToCheck);
+		if (EntryToCheck != INDEX_NONE)
+		{
+			bool bAllFound = true;
+			if (ContainsSubtreeOf(*FlatDictionary, Events, EntryToCheck, bAllFound))
+			{
+				return true;
+			}
+			if (bAllFound)
+			{
+				return false;
+			}
+		}
+	}
+
+	// Check explicit and parent tag list 
+	return Events.Contains(TagToCheck) || ParentTags.Contains(TagToCheck);
+}
+
+bool FEventContainer::HasTag(FEventIndex EventIndex) const
+{
+	const FEventDictionaryPtr FlatDictionary = UEventsManager::Get().GetDictionary();
+	const int32 EntryToCheck = FlatDictionary ? FlatDictionary->Find(EventIndex) : INDEX_NONE;
+	if (EntryToCheck == INDEX_NONE)
+	{
+		return false;
+	}
+
+	bool bAllFound = true;
+	if (ContainsSubtreeOf(*FlatDictionary, Events, EntryToCheck, bAllFound))
+	{
+		return true;
+	}
+	return !bAllFound && ParentTags.Contains(FEventInfo(FlatDictionary->GetTagName(EntryToCheck)));
+}
+
+bool FEventContainer::HasAny(const FEventContainer& ContainerToCheck) const
+{
+	if (ContainerToCheck.IsEmpty())
+	{
+		return false;
+	}
+
+	const FEventDictionaryPtr FlatDictionary = UEventsManager::Get().GetDictionary();
+	for (const FEventInfo& OtherTag : ContainerToCheck.Events)
+	{
+		const int32 EntryToCheck = FlatDictionary ? FlatDictionary->Find(OtherTag) : INDEX_NONE;
+		bool bAllFound = EntryToCheck != INDEX_NONE;
+		if (bAllFound && ContainsSubtreeOf(*FlatDictionary, Events, EntryToCheck, bAllFound))
+		{
+			return true;
+		}
+		if (!bAllFound && (Events.Contains(OtherTag) || ParentTags.Contains(OtherTag)))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 bool FEventContainer::ComplexHasTag(FEventInfo const& TagToCheck, TEnumAsByte<EEventMatchType::Type> TagMatchType, TEnumAsByte<EEventMatchType::Type> TagToCheckMatchType) const
 {
 	check(TagMatchType != EEventMatchType::Explicit || TagToCheckMatchType != EEventMatchType::Explicit);
@@ -548,10 +639,13 @@ bool FEventContainer::ComplexHasTag(FEventInfo const& TagToCheck, TEnumAsByte<EE
 	}
 	else
 	{
-		const FEventContainer* SingleContainer = UEventsManager::Get().GetSingleTagContainer(TagToCheck);
-		if (SingleContainer && SingleContainer->DoesTagContainerMatch(*this, EEventMatchType::IncludeParentTags, EEventMatchType::Explicit, EEventContainerMatchType::Any))
+		const FEventParentChain Chain = UEventsManager::Get().GetSingleTagContainer(TagToCheck);
+		for (const FEventInfo& Tag : Events)
 		{
-			return true;
+			if (Chain.HasTag(Tag))
+			{
+				return true;
+			}
 		}
 
 	}
@@ -578,15 +672,12 @@ bool FEventContainer::RemoveTagByExplicitName(const FName& TagName)
 
 FORCEINLINE_DEBUGGABLE void FEventContainer::AddParentsForTag(const FEventInfo& Tag)
 {
-	const FEventContainer* SingleContainer = UEventsManager::Get().GetSingleTagContainer(Tag);
+	const FEventParentChain Chain = UEventsManager::Get().GetSingleTagContainer(Tag);
 
-	if (SingleContainer)
+	// Add Parent tags from this tag to our own
+	for (const FEventInfo& ParentTag : Chain.GetParents())
 	{
-		// Add Parent tags from this tag to our own
-		for (const FEventInfo& ParentTag : SingleContainer->ParentTags)
-		{
-			ParentTags.AddUnique(ParentTag);
-		}
+		ParentTags.AddUnique(ParentTag);
 	}
 }
 
@@ -797,16 +888,16 @@ bool FEventContainer::AddLeafTag(const FEventInfo& TagToAdd)
 		return false;
 	}
 
-	const FEventContainer* TagToAddContainer = UEventsManager::Get().GetSingleTagContainer(TagToAdd);
+	const FEventParentChain TagToAddChain = UEventsManager::Get().GetSingleTagContainer(TagToAdd);
 
 	// This should always succeed
-	if (!ensure(TagToAddContainer))
+	if (!ensure(TagToAddChain.IsValid()))
 	{
 		return false;
 	}
 
 	// Remove any tags in the container that are a parent to TagToAdd
-	for (const FEventInfo& ParentTag : TagToAddContainer->ParentTags)
+	for (const FEventInfo& ParentTag : TagToAddChain.GetParents())
 	{
 		if (HasTagExact(ParentTag))
 		{
@@ -1073,15 +1164,15 @@ bool FEventInfo::ComplexMatches(TEnumAsByte<EEventMatchType::Type> MatchTypeOne,
 
 DECLARE_CYCLE_STAT(TEXT("FEventBase::GetSingleTagContainer"), STAT_FEvent_GetSingleTagContainer, STATGROUP_Events);
 
-const FEventContainer& FEventInfo::GetSingleTagContainer() const
+FEventContainer FEventInfo::GetSingleTagContainer() const
 {
 	SCOPE_CYCLE_COUNTER(STAT_FEvent_GetSingleTagContainer);
 
-	const FEventContainer* TagContainer = UEventsManager::Get().GetSingleTagContainer(*this);
+	const FEventParentChain Chain = UEventsManager::Get().GetSingleTagContainer(*this);
 
-	if (TagContainer)
+	if (Chain.IsValid())
 	{
-		return *TagContainer;
+		return Chain.ToContainer();
 	}
 
 	// This should always be invalid if the node is missing
@@ -1111,11 +1202,22 @@ bool FEventInfo::MatchesTag(const FEventInfo& TagToCheck) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_FEvent_MatchesTag);
 
-	const FEventContainer* TagContainer = UEventsManager::Get().GetSingleTagContainer(*this);
+	// "A.1" matches "A" if A.1 lies in the pre-order range of A, no parent list to scan
+	if (const FEventDictionaryPtr FlatDictionary = UEventsManager::Get().GetDictionary())
+	{
+		const int32 Entry = FlatDictionary->Find(*this);
+		if (Entry != INDEX_NONE)
+		{
+			const int32 EntryToCheck = FlatDictionary->Find(TagToCheck);
+			return EntryToCheck != INDEX_NONE && FlatDictionary->IsInSubtree(Entry, EntryToCheck);
+		}
+	}
+
+	const FEventParentChain Chain = UEventsManager::Get().GetSingleTagContainer(*this);
 
-	if (TagContainer)
+	if (Chain.IsValid())
 	{
-		return TagContainer->HasTag(TagToCheck);
+		return Chain.HasTag(TagToCheck);
 	}
 
 	// This should always be invalid if the node is missing
@@ -1130,11 +1232,28 @@ bool FEventInfo::MatchesAny(const FEventContainer& ContainerToCheck) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_FEvent_MatchesAny);
 
-	const FEventContainer* TagContainer = UEventsManager::Get().GetSingleTagContainer(*this);
+	if (const FEventDictionaryPtr FlatDictionary = UEventsManager::Get().GetDictionary())
+	{
+		const int32 Entry = FlatDictionary->Find(*this);
+		if (Entry != INDEX_NONE)
+		{
+			for (const FEventInfo& OtherTag : ContainerToCheck)
+			{
+				const int32 EntryToCheck = FlatDictionary->Find(OtherTag);
+				if (EntryToCheck != INDEX_NONE && FlatDictionary->IsInSubtree(Entry, EntryToCheck))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+	const FEventParentChain Chain = UEventsManager::Get().GetSingleTagContainer(*this);
 
-	if (TagContainer)
+	if (Chain.IsValid())
 	{
-		return TagContainer->HasAny(ContainerToCheck);
+		return Chain.HasAny(ContainerToCheck);
 	}
 
 	// This should always be invalid if the node is missing
@@ -1147,6 +1266,35 @@ int32 FEventInfo::MatchesTagDepth(const FEventInfo& TagToCheck) const
 	return UEventsManager::Get().EventsMatchDepth(*this, TagToCheck);
 }
 
+FEventIndex FEventInfo::GetEventIndex() const
+{
+	return UEventsManager::Get().GetEventIndex(*this);
+}
+
+FEventInfo FEventInfo::FromEventIndex(FEventIndex EventIndex)
+{
+	return UEventsManager::Get().GetEventFromIndex(EventIndex);
+}
+
+FEventKey FEventInfo::GetChannelKey() const
+{
+	if (!IsValid())
+	{
+		return FEventKey();
+	}
+
+	// Tags the dictionary knows carry their index, tags it doesn't know register their name like any other event id
+	if (const FEventDictionaryPtr FlatDictionary = UEventsManager::Get().GetDictionary())
+	{
+		const int32 Entry = FlatDictionary->Find(*this);
+		if (Entry != INDEX_NONE)
+		{
+			return FlatDictionary->GetChannelKey(Entry);
+		}
+	}
+	return FEventKey::FindOrAdd(TagName.ToString());
+}
+
 FEventInfo::FEventInfo(const FName& Name)
 	: TagName(Name)
 {
@@ -1189,17 +1337,20 @@ static TSharedPtr<FNetFieldExportGroup> CreateNetfieldExportGroupForNetworkEvent
 {
 	TSharedPtr<FNetFieldExportGroup> NetFieldExportGroup = TSharedPtr<FNetFieldExportGroup>(new FNetFieldExportGroup());
 
-	const TArray<TSharedPtr<FEventNode>>& NetworkEventNodeIndex = TagManager.GetNetworkEventNodeIndex();
+	// Cooked builds release the tree, the published dictionary keeps the net indices
+	const FEventDictionaryPtr Dictionary = TagManager.GetDictionary();
+	const int32 NumNetIndices = Dictionary ? Dictionary->GetNumNetIndices() : 0;
 
 	NetFieldExportGroup->PathName = NetFieldExportGroupName;
-	NetFieldExportGroup->NetFieldExports.SetNum(NetworkEventNodeIndex.Num());
+	NetFieldExportGroup->NetFieldExports.SetNum(NumNetIndices);
 
-	for (int32 i = 0; i < NetworkEventNodeIndex.Num(); i++)
+	for (int32 i = 0; i < NumNetIndices; i++)
 	{
+		const int32 Entry = Dictionary->FindByNetIndex(i);
 		FNetFieldExport NetFieldExport(
 			i,
 			0,
-			NetworkEventNodeIndex[i]->GetCompleteTagName());
+			Entry != INDEX_NONE ? Dictionary->GetTagName(Entry) : NAME_None);
 
 		NetFieldExportGroup->NetFieldExports[i] = NetFieldExport;
 	}
@@ -1937,6 +2088,25 @@ FAutoConsoleCommand EventPrintReplicationMapCmd(
 	FConsoleCommandDelegate::CreateStatic(EventPrintReplicationMap)
 );
 
+static void EventWriteReplicationReport(const TArray<FString>& Args)
+{
+	const FString Filename = Args.Num() > 0 ? Args[0] : FPaths::ProjectSavedDir() / TEXT("Events") / TEXT("ReplicationReport.csv");
+	if (UEventsManager::Get().WriteReplicationFrequencyReport(Filename))
+	{
+		UE_LOG(LogEvents, Display, TEXT("Wrote event replication report to %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Can't write event replication report to %s"), *Filename);
+	}
+}
+
+FAutoConsoleCommand EventWriteReplicationReportCmd(
+	TEXT("Events.WriteReport"), 
+	TEXT( "Saves the frequency of replicated gameplay tags for the EventsReplicationTuning commandlet. Optional argument: file name" ), 
+	FConsoleCommandWithArgsDelegate::CreateStatic(EventWriteReplicationReport)
+);
+
 static void EventPrintReplicationIndices()
 {
 	UEventsManager::Get().PrintReplicationIndices();
@@ -0,0 +1,119 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventDictionary.h"
+#include "EventsManager.h"
+
+void FEventDictionary::Build(const FEventNode& Root, uint16 InGeneration, TArrayView<const TSharedPtr<FEventNode>> NetOrder)
+{
+	Reset();
+	Generation = InGeneration;
+
+	// Same numbering as UEventsManager::AssignNetIndices, which drops everything past the last valid index
+	TMap<const FEventNode*, FEventNetIndex> NetOrderIndices;
+	NetOrderIndices.Reserve(NetOrder.Num());
+	for (int32 Index = 0; Index < NetOrder.Num() && Index < INVALID_TAGNETINDEX - 1; ++Index)
+	{
+		NetOrderIndices.Add(NetOrder[Index].Get(), (FEventNetIndex)Index);
+	}
+	auto GetNetIndex = [&NetOrder, &NetOrderIndices](const FEventNode* Node)
+	{
+		if (NetOrder.Num() == 0)
+		{
+			return Node->GetNetIndex();
+		}
+		const FEventNetIndex* Found = NetOrderIndices.Find(Node);
+		return Found ? *Found : (FEventNetIndex)INVALID_TAGNETINDEX;
+	};
+
+	// Depth first with an explicit stack, children are pushed in reverse so they come out in tag order
+	TArray<TPair<const FEventNode*, int32>> Stack;
+	for (int32 ChildIdx = Root.GetChildTagNodes().Num() - 1; ChildIdx >= 0; --ChildIdx)
+	{
+		Stack.Emplace(Root.GetChildTagNodes()[ChildIdx].Get(), INDEX_NONE);
+	}
+
+	FEventNetIndex MaxNetIndex = 0;
+	while (Stack.Num())
+	{
+		const TPair<const FEventNode*, int32> Entry = Stack.Pop(false);
+		const FEventNode* Node = Entry.Key;
+		const int32 Parent = Entry.Value;
+		const int32 Index = TagNames.Num();
+
+		TagNames.Add(Node->GetCompleteTagName());
+		SimpleNames.Add(Node->GetSimpleTagName());
+		Parents.Add(Parent);
+		SubtreeEnds.Add(Index + 1);
+		Depths.Add(Parent == INDEX_NONE ? 0 : (uint8)FMath::Min(Depths[Parent] + 1, (int32)MAX_uint8));
+		const FEventNetIndex NetIndex = GetNetIndex(Node);
+		NetIndices.Add(NetIndex);
+		ChannelKeys.Add(FEventKey::FindOrAdd(TagNames.Last().ToString()));
+		NameToIndex.Add(TagNames.Last(), Index);
+
+		if (Node->Parameters.Num() || Node->Throttle.IsActive() || Node->Replication != EEventReplicationPolicy::ServerToClient)
+		{
+			FEventEntryData& Data = EntryData.Add(Index);
+			for (const FEventParameter& Parameter : Node->Parameters)
+			{
+				Data.Parameters.Add({ Parameter.Name, Parameter.Type.ToString() });
+			}
+			Data.Throttle = Node->Throttle;
+			Data.Replication = Node->Replication;
+		}
+
+		if (NetIndex != INVALID_TAGNETINDEX)
+		{
+			MaxNetIndex = FMath::Max(MaxNetIndex, NetIndex);
+		}
+
+		const TArray<TSharedPtr<FEventNode>>& Children = Node->GetChildTagNodes();
+		for (int32 ChildIdx = Children.Num() - 1; ChildIdx >= 0; --ChildIdx)
+		{
+			Stack.Emplace(Children[ChildIdx].Get(), Index);
+		}
+	}
+
+	// Children come after their parent, so walking backwards finishes every subtree before its parent reads it
+	for (int32 Index = Parents.Num() - 1; Index >= 0; --Index)
+	{
+		if (Parents[Index] != INDEX_NONE)
+		{
+			SubtreeEnds[Parents[Index]] = FMath::Max(SubtreeEnds[Parents[Index]], SubtreeEnds[Index]);
+		}
+	}
+
+	NetIndexToEntry.Init(INDEX_NONE, Num() ? MaxNetIndex + 1 : 0);
+	for (int32 Index = 0; Index < NetIndices.Num(); ++Index)
+	{
+		if (NetIndices[Index] != INVALID_TAGNETINDEX)
+		{
+			NetIndexToEntry[NetIndices[Index]] = Index;
+		}
+	}
+
+	SearchIndex.Build(TagNames);
+
+	UE_CLOG(Num() > INVALID_EVENTINDEX, LogEvents, Warning, TEXT("%d events don't fit in FEventIndex, only the first %d have compact indices"), Num(), INVALID_EVENTINDEX);
+}
+
+const FEventEntryData& FEventDictionary::GetEntryData(int32 Index) const
+{
+	static const FEventEntryData DefaultData = { {}, FEventThrottle(), EEventReplicationPolicy::ServerToClient };
+	const FEventEntryData* Data = EntryData.Find(Index);
+	return Data ? *Data : DefaultData;
+}
+
+void FEventDictionary::Reset()
+{
+	TagNames.Reset();
+	SimpleNames.Reset();
+	Parents.Reset();
+	SubtreeEnds.Reset();
+	Depths.Reset();
+	NetIndices.Reset();
+	ChannelKeys.Reset();
+	EntryData.Reset();
+	NameToIndex.Reset();
+	NetIndexToEntry.Reset();
+	SearchIndex.Reset();
+}
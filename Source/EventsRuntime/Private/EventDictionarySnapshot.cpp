@@ -0,0 +1,173 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventDictionarySnapshot.h"
+#include "EventsManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static_assert(sizeof(FEventDictionarySnapshot::FHeader) == 40, "Snapshot header layout changed, bump FileVersion");
+static_assert(sizeof(FEventDictionarySnapshot::FEntry) == 32, "Snapshot entry layout changed, bump FileVersion");
+static_assert(sizeof(FEventDictionarySnapshot::FParameter) == 8, "Snapshot parameter layout changed, bump FileVersion");
+
+bool FEventDictionarySnapshot::Write(const UEventsManager& Manager, const FString& Filename)
+{
+	const FEventDictionaryPtr Dictionary = Manager.GetDictionary();
+	if (!Dictionary)
+	{
+		return false;
+	}
+
+	TArray<ANSICHAR> Strings;
+	TMap<FName, uint32> StringOffsets;
+	auto AddString = [&Strings, &StringOffsets](FName Name)
+	{
+		if (const uint32* Offset = StringOffsets.Find(Name))
+		{
+			return *Offset;
+		}
+
+		const uint32 Offset = Strings.Num();
+		FTCHARToUTF8 Converted(*Name.ToString());
+		Strings.Append(Converted.Get(), Converted.Length());
+		Strings.Add('\0');
+		StringOffsets.Add(Name, Offset);
+		return Offset;
+	};
+
+	TArray<FEntry> Entries;
+	TArray<FParameter> Parameters;
+	Entries.Reserve(Dictionary->Num());
+	for (int32 Index = 0; Index < Dictionary->Num(); ++Index)
+	{
+		const FName TagName = Dictionary->GetTagName(Index);
+		TSharedPtr<FEventNode> Node = Manager.FindTagNode(TagName);
+
+		FEntry& Entry = Entries.AddZeroed_GetRef();
+		Entry.SimpleName = AddString(Dictionary->GetSimpleTagName(Index));
+		Entry.CompleteName = AddString(TagName);
+		Entry.Parent = Dictionary->GetParent(Index);
+		Entry.NetIndex = Dictionary->GetNetIndex(Index);
+		Entry.FirstParameter = Parameters.Num();
+
+		if (Node.IsValid())
+		{
+			Entry.NumParameters = Node->Parameters.Num();
+			Entry.MaxRate = Node->Throttle.MaxRate;
+			Entry.MinInterval = Node->Throttle.MinInterval;
+			Entry.bDeliverTrailing = Node->Throttle.bDeliverTrailing;
+			Entry.Replication = (uint8)Node->Replication;
+
+			for (const FEventParameter& Parameter : Node->Parameters)
+			{
+				FParameter& Record = Parameters.AddZeroed_GetRef();
+				Record.Name = AddString(Parameter.Name);
+				Record.Type = AddString(Parameter.Type);
+			}
+		}
+	}
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = FileMagic;
+	Header.Version = FileVersion;
+	Header.NumEntries = Entries.Num();
+	Header.NumParameters = Parameters.Num();
+	Header.StringBytes = Strings.Num();
+	Header.NetworkHash = Manager.GetNetworkEventNodeIndexHash();
+	Header.bHasNetIndices = Manager.ShouldUseFastReplication();
+	Header.IniHash = Manager.GetIniSourceHash();
+	Header.TableHash = Manager.GetEventTableHash();
+
+	TArray<uint8> Bytes;
+	Bytes.Append((const uint8*)&Header, sizeof(Header));
+	Bytes.Append((const uint8*)Entries.GetData(), Entries.Num() * sizeof(FEntry));
+	Bytes.Append((const uint8*)Parameters.GetData(), Parameters.Num() * sizeof(FParameter));
+	Bytes.Append((const uint8*)Strings.GetData(), Strings.Num());
+
+	return FFileHelper::SaveArrayToFile(Bytes, *Filename);
+}
+
+TUniquePtr<FEventDictionarySnapshot> FEventDictionarySnapshot::Open(const FString& Filename)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Filename))
+	{
+		return nullptr;
+	}
+
+	TUniquePtr<FEventDictionarySnapshot> Snapshot(new FEventDictionarySnapshot());
+
+	// Mapping only works for loose files, a snapshot inside a pak is read into memory instead
+	Snapshot->MappedHandle.Reset(PlatformFile.OpenMapped(*Filename));
+	if (Snapshot->MappedHandle.IsValid())
+	{
+		Snapshot->MappedRegion.Reset(Snapshot->MappedHandle->MapRegion(0, Snapshot->MappedHandle->GetFileSize()));
+	}
+
+	if (Snapshot->MappedRegion.IsValid())
+	{
+		Snapshot->Data = Snapshot->MappedRegion->GetMappedPtr();
+		Snapshot->Size = Snapshot->MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(Snapshot->LoadedData, *Filename))
+	{
+		Snapshot->Data = Snapshot->LoadedData.GetData();
+		Snapshot->Size = Snapshot->LoadedData.Num();
+	}
+
+	if (!Snapshot->Validate())
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Ignoring event dictionary snapshot %s, it is corrupt or from another version"), *Filename);
+		return nullptr;
+	}
+	return Snapshot;
+}
+
+FString FEventDictionarySnapshot::GetDefaultFilename()
+{
+	return FPaths::ProjectContentDir() / TEXT("Events") / TEXT("EventDictionary.bin");
+}
+
+bool FEventDictionarySnapshot::Validate() const
+{
+	if (!Data || Size < (int64)sizeof(FHeader))
+	{
+		return false;
+	}
+
+	const FHeader& Header = GetHeader();
+	if (Header.Magic != FileMagic || Header.Version != FileVersion)
+	{
+		return false;
+	}
+
+	const int64 ExpectedSize = sizeof(FHeader) + (int64)Header.NumEntries * sizeof(FEntry) + (int64)Header.NumParameters * sizeof(FParameter) + Header.StringBytes;
+	if (Size != ExpectedSize || (Header.StringBytes && GetString(Header.StringBytes - 1)[0] != '\0'))
+	{
+		return false;
+	}
+
+	// Everything the loader dereferences is checked once here, so it can trust the records
+	const FEntry* Entries = GetEntries();
+	for (uint32 Index = 0; Index < Header.NumEntries; ++Index)
+	{
+		const FEntry& Entry = Entries[Index];
+		if (Entry.SimpleName >= Header.StringBytes || Entry.CompleteName >= Header.StringBytes || Entry.Parent >= (int32)Index || Entry.Parent < INDEX_NONE
+			|| Entry.Replication > (uint8)EEventReplicationPolicy::Both
+			|| (uint64)Entry.FirstParameter + Entry.NumParameters > Header.NumParameters)
+		{
+			return false;
+		}
+	}
+
+	const FParameter* Parameters = GetParameters();
+	for (uint32 Index = 0; Index < Header.NumParameters; ++Index)
+	{
+		if (Parameters[Index].Name >= Header.StringBytes || Parameters[Index].Type >= Header.StringBytes)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,357 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventReplicationComponent.h"
+#include "EventsManager.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/CoreNet.h"
+#include "Systems/GIEventSubsystem.h"
+
+namespace EventReplication
+{
+	FEventChannel* GetChannel(const UWorld* World)
+	{
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		UGIEventSubsystem* System = GameInstance ? GameInstance->GetSubsystem<UGIEventSubsystem>() : nullptr;
+		return System ? &System->GetChannel() : nullptr;
+	}
+
+	/** Most entries a single batch may carry, counts past it are treated as a corrupt or hostile packet */
+	static constexpr uint32 MaxBatchEntries = 1024;
+
+	/** Moves up to MaxBatchEntries entries out of Pending, the rest stay queued */
+	FEventNetBatch TakeBatch(FEventNetBatch& Pending)
+	{
+		FEventNetBatch Batch;
+		if ((uint32)Pending.Entries.Num() <= MaxBatchEntries)
+		{
+			Swap(Batch.Entries, Pending.Entries);
+			return Batch;
+		}
+
+		Batch.Entries.Reserve(MaxBatchEntries);
+		for (uint32 Index = 0; Index < MaxBatchEntries; ++Index)
+		{
+			Batch.Entries.Add(MoveTemp(Pending.Entries[Index]));
+		}
+		Pending.Entries.RemoveAt(0, MaxBatchEntries);
+		return Batch;
+	}
+
+	/** World the batch is received in, found through the connection it arrived on */
+	const UWorld* GetWorld(UPackageMap* Map)
+	{
+		UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+		UNetConnection* Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+		return Connection && Connection->Driver ? Connection->Driver->GetWorld() : nullptr;
+	}
+
+	/**
+	 * True if Property can be packed with its net serializer. Containers and structs without a native NetSerialize
+	 * only have the deprecated, fatal path, delegates can't cross the network at all.
+	 */
+	bool IsNetSerializable(const FProperty* Property)
+	{
+		if (const FStructProperty* StructProperty = CastField<const FStructProperty>(Property))
+		{
+			return (StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative) != 0;
+		}
+		return Property->IsA<FNumericProperty>() || Property->IsA<FBoolProperty>() || Property->IsA<FEnumProperty>()
+			|| Property->IsA<FNameProperty>() || Property->IsA<FStrProperty>() || Property->IsA<FTextProperty>()
+			|| Property->IsA<FObjectPropertyBase>();
+	}
+
+	bool IsNetSerializable(const FEventSchema::FParameterList& Layout)
+	{
+		return !Layout.ContainsByPredicate([](const FProperty* Property) { return !Property || !IsNetSerializable(Property); });
+	}
+
+	/**
+	 * Layout payloads of Event are packed and read with. The dictionary declaration is the same on every machine
+	 * whoever listens, only events declared without parameters fall back to the local listeners.
+	 */
+	bool GetPackLayout(FEventChannel* Channel, const FEventInfo& Event, FEventSchema::FParameterList& OutLayout)
+	{
+		const FString EventId = Event.GetTagName().ToString();
+		return Channel && (Channel->GetDeclaredLayout(EventId, OutLayout) || Channel->GetLayout(EventId, OutLayout));
+	}
+
+	/** True if the replication policy of Event lets it be sent by a client, or by the server when bFromClient is false */
+	bool IsAllowed(const FEventInfo& Event, bool bFromClient)
+	{
+		const FEventDictionaryPtr Dictionary = UEventsManager::Get().GetDictionary();
+		const int32 Index = Dictionary ? Dictionary->Find(Event) : INDEX_NONE;
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const EEventReplicationPolicy Replication = Dictionary->GetEntryData(Index).Replication;
+		const EEventReplicationPolicy Allowed = bFromClient ? EEventReplicationPolicy::ClientToServer : EEventReplicationPolicy::ServerToClient;
+		return Replication == Allowed || Replication == EEventReplicationPolicy::Both;
+	}
+}
+
+bool FEventNetBatch::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint32 NumEntries = Entries.Num();
+	Ar.SerializeIntPacked(NumEntries);
+
+	if (Ar.IsSaving())
+	{
+		for (FEventNetEntry& Entry : Entries)
+		{
+			bool bTagSuccess = true;
+			Entry.Event.NetSerialize_Packed(Ar, Map, bTagSuccess);
+
+			UObject* Sender = Entry.Sender.Get();
+			Map->SerializeObject(Ar, UObject::StaticClass(), Sender);
+
+			FNetBitWriter PayloadWriter(Map, 0);
+			for (FOutputParam& Value : Entry.Payload->Values)
+			{
+				Value.Property->NetSerializeItem(PayloadWriter, Map, Value.PropAddr);
+			}
+
+			uint32 NumBits = PayloadWriter.GetNumBits();
+			Ar.SerializeIntPacked(NumBits);
+			Ar.SerializeBits(PayloadWriter.GetData(), NumBits);
+		}
+		return true;
+	}
+
+	// Every entry takes at least one bit per field, a count the rest of the packet can't hold is never reserved
+	const int64 RemainingBits = Ar.GetNumBits() - Ar.GetPosBits();
+	if (NumEntries > EventReplication::MaxBatchEntries || (int64)NumEntries > RemainingBits)
+	{
+		Ar.SetError();
+		bOutSuccess = false;
+		return true;
+	}
+
+	FEventChannel* Channel = EventReplication::GetChannel(EventReplication::GetWorld(Map));
+
+	Entries.Reset(NumEntries);
+	for (uint32 Index = 0; Index < NumEntries && !Ar.IsError(); ++Index)
+	{
+		FEventNetEntry Entry;
+		bool bTagSuccess = true;
+		Entry.Event.NetSerialize_Packed(Ar, Map, bTagSuccess);
+
+		UObject* Sender = nullptr;
+		Map->SerializeObject(Ar, UObject::StaticClass(), Sender);
+		Entry.Sender = Sender;
+
+		uint32 NumBits = 0;
+		Ar.SerializeIntPacked(NumBits);
+		if ((int64)NumBits > (int64)Ar.GetMaxSerializeSize() * 8 || (int64)NumBits > Ar.GetNumBits() - Ar.GetPosBits())
+		{
+			Ar.SetError();
+			break;
+		}
+
+		TArray<uint8> PayloadBits;
+		PayloadBits.SetNumZeroed((NumBits + 7) >> 3);
+		Ar.SerializeBits(PayloadBits.GetData(), NumBits);
+
+		// Payloads are read with the layout they were packed with, see GetPackLayout
+		FEventSchema::FParameterList Layout;
+		if (!Entry.Event.IsValid() || (!EventReplication::GetPackLayout(Channel, Entry.Event, Layout) && NumBits))
+		{
+			continue;
+		}
+
+		if (!EventReplication::IsNetSerializable(Layout))
+		{
+			UE_LOG(LogEvents, Warning, TEXT("Dropped replicated event %s, the local listeners take parameters that can't be replicated"), *Entry.Event.ToString());
+			continue;
+		}
+
+		Entry.Payload = MakeShared<FEventPayload, ESPMode::ThreadSafe>(Layout);
+		FNetBitReader PayloadReader(Map, PayloadBits.GetData(), NumBits);
+		for (FOutputParam& Value : Entry.Payload->Values)
+		{
+			Value.Property->NetSerializeItem(PayloadReader, Map, Value.PropAddr);
+		}
+
+		if (PayloadReader.IsError() || !PayloadReader.AtEnd())
+		{
+			UE_LOG(LogEvents, Warning, TEXT("Dropped replicated event %s, its payload doesn't match the local declaration"), *Entry.Event.ToString());
+			continue;
+		}
+
+		Entries.Add(MoveTemp(Entry));
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+UEventReplicationComponent::UEventReplicationComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+	SetIsReplicatedByDefault(true);
+}
+
+UEventReplicationComponent* UEventReplicationComponent::Get(const APlayerController* PlayerController)
+{
+	return PlayerController ? PlayerController->FindComponentByClass<UEventReplicationComponent>() : nullptr;
+}
+
+void UEventReplicationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// One RPC per direction and frame, batches past the receiver's cap carry over to the next frame
+	if (PendingToServer.Entries.Num())
+	{
+		ServerReceiveEvents(EventReplication::TakeBatch(PendingToServer));
+	}
+
+	if (PendingToClient.Entries.Num())
+	{
+		ClientReceiveEvents(EventReplication::TakeBatch(PendingToClient));
+	}
+
+	SetComponentTickEnabled(PendingToServer.Entries.Num() > 0 || PendingToClient.Entries.Num() > 0);
+}
+
+void UEventReplicationComponent::SendToServerWithParams(const FEventInfo& Event, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	if (!EventReplication::IsAllowed(Event, true))
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Event %s can't be sent by a client, its replication policy doesn't allow it"), *Event.ToString());
+		return;
+	}
+	Enqueue(PendingToServer, Event, Sender, CopyPayload(this, Event, Params));
+}
+
+void UEventReplicationComponent::SendToClientWithParams(const FEventInfo& Event, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	if (GetOwnerRole() != ROLE_Authority)
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Only the server can send event %s to a client"), *Event.ToString());
+		return;
+	}
+	if (!EventReplication::IsAllowed(Event, false))
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Event %s can't be sent by the server, its replication policy doesn't allow it"), *Event.ToString());
+		return;
+	}
+	Enqueue(PendingToClient, Event, Sender, CopyPayload(this, Event, Params));
+}
+
+void UEventReplicationComponent::MulticastWithParams(const UObject* WorldContext, const FEventInfo& Event, UObject* Sender, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World || World->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	if (!EventReplication::IsAllowed(Event, false))
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Event %s can't be sent by the server, its replication policy doesn't allow it"), *Event.ToString());
+		return;
+	}
+
+	// The payload is copied once and shared by the batch of every connection
+	FEventPayloadPtr Payload = CopyPayload(World, Event, Params);
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (UEventReplicationComponent* Component = Get(It->Get()))
+		{
+			Component->Enqueue(Component->PendingToClient, Event, Sender, Payload);
+		}
+	}
+}
+
+void UEventReplicationComponent::ServerReceiveEvents_Implementation(const FEventNetBatch& Batch)
+{
+	Deliver(Batch, true);
+}
+
+void UEventReplicationComponent::ClientReceiveEvents_Implementation(const FEventNetBatch& Batch)
+{
+	Deliver(Batch, false);
+}
+
+FEventPayloadPtr UEventReplicationComponent::CopyPayload(const UObject* WorldContext, const FEventInfo& Event, const TArray<FOutputParam, TInlineAllocator<8>>& Params)
+{
+	FEventSchema::FParameterList Layout;
+	FEventChannel* Channel = EventReplication::GetChannel(WorldContext ? WorldContext->GetWorld() : nullptr);
+	if (!EventReplication::GetPackLayout(Channel, Event, Layout) && Params.Num())
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Can't replicate event %s, the dictionary doesn't declare its parameters"), *Event.ToString());
+		return nullptr;
+	}
+
+	bool bMatches = Layout.Num() == Params.Num();
+	for (int32 Index = 0; bMatches && Index < Layout.Num(); ++Index)
+	{
+		bMatches = FEventSchema::ParamMatches(Params[Index], Layout[Index]) && Params[Index].PropAddr;
+	}
+
+	if (!bMatches)
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Can't replicate event %s, its payload has no layout to be packed with"), *Event.ToString());
+		return nullptr;
+	}
+
+	if (!EventReplication::IsNetSerializable(Layout))
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Can't replicate event %s, arrays, sets, maps, delegates and structs without a native NetSerialize can't be packed"), *Event.ToString());
+		return nullptr;
+	}
+	return MakeShared<FEventPayload, ESPMode::ThreadSafe>(Layout, Params);
+}
+
+void UEventReplicationComponent::Enqueue(FEventNetBatch& Batch, const FEventInfo& Event, UObject* Sender, const FEventPayloadPtr& Payload)
+{
+	if (!Payload.IsValid() || !Event.IsValid())
+	{
+		return;
+	}
+
+	FEventNetEntry& Entry = Batch.Entries.AddDefaulted_GetRef();
+	Entry.Event = Event;
+	Entry.Sender = Sender;
+	Entry.Payload = Payload;
+
+	SetComponentTickEnabled(true);
+}
+
+void UEventReplicationComponent::Deliver(const FEventNetBatch& Batch, bool bFromClient)
+{
+	FEventChannel* Channel = EventReplication::GetChannel(GetWorld());
+	if (!Channel)
+	{
+		return;
+	}
+
+	// A client can put any event in its batch, only the ones its side may send are delivered
+	int32 NumRejected = 0;
+	for (const FEventNetEntry& Entry : Batch.Entries)
+	{
+		if (!EventReplication::IsAllowed(Entry.Event, bFromClient))
+		{
+			++NumRejected;
+			continue;
+		}
+		Channel->NotifyEventWithParams(Entry.Event.GetTagName().ToString(), Entry.Sender.Get(), Entry.Payload->Values);
+	}
+
+	if (NumRejected)
+	{
+		UE_LOG(LogEvents, Warning, TEXT("Dropped %d events from %s, their replication policy doesn't allow the %s to send them"), NumRejected, *GetNameSafe(GetOwner()), bFromClient ? TEXT("client") : TEXT("server"));
+	}
+}
@@ -0,0 +1,172 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "EventSearchIndex.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+
+void FEventSearchIndex::Build(TArrayView<const FName> Names)
+{
+	Reset();
+
+	TextStart.Reserve(Names.Num() + 1);
+	for (FName Name : Names)
+	{
+		TextStart.Add(Text.Num());
+		const FString Lower = Name.ToString().ToLower();
+		Text.Append(*Lower, Lower.Len() + 1);
+	}
+	TextStart.Add(Text.Num());
+
+	SortedEntries.SetNumUninitialized(Names.Num());
+	for (int32 Entry = 0; Entry < Names.Num(); ++Entry)
+	{
+		SortedEntries[Entry] = Entry;
+	}
+	Algo::Sort(SortedEntries, [this](int32 A, int32 B) { return FCString::Strcmp(GetText(A), GetText(B)) < 0; });
+
+	TArray<TPair<uint64, int32>> Pairs;
+	TArray<uint64, TInlineAllocator<64>> Trigrams;
+	for (int32 Entry = 0; Entry < Names.Num(); ++Entry)
+	{
+		GetTrigrams(GetText(Entry), GetTextLen(Entry), Trigrams);
+		for (uint64 Trigram : Trigrams)
+		{
+			Pairs.Emplace(Trigram, Entry);
+		}
+	}
+	Algo::Sort(Pairs, [](const TPair<uint64, int32>& A, const TPair<uint64, int32>& B) { return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value); });
+
+	Postings.SetNumUninitialized(Pairs.Num());
+	for (int32 Index = 0; Index < Pairs.Num(); ++Index)
+	{
+		Postings[Index] = Pairs[Index].Value;
+
+		TPair<int32, int32>& Range = TrigramRanges.FindOrAdd(Pairs[Index].Key, TPair<int32, int32>(Index, 0));
+		++Range.Value;
+	}
+}
+
+void FEventSearchIndex::Reset()
+{
+	Text.Reset();
+	TextStart.Reset();
+	SortedEntries.Reset();
+	TrigramRanges.Reset();
+	Postings.Reset();
+}
+
+void FEventSearchIndex::Search(const FString& Query, EEventSearchMode Mode, TArray<int32>& OutEntries, int32 MaxResults) const
+{
+	OutEntries.Reset();
+
+	const FString Lower = Query.ToLower();
+	if (Lower.IsEmpty() || TextStart.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 Cap = MaxResults > 0 ? MaxResults : MAX_int32;
+	if (Mode == EEventSearchMode::Prefix)
+	{
+		int32 Index = Algo::LowerBound(SortedEntries, Lower, [this](int32 Entry, const FString& Value) { return FCString::Strcmp(GetText(Entry), *Value) < 0; });
+		for (; Index < SortedEntries.Num() && OutEntries.Num() < Cap && !FCString::Strncmp(GetText(SortedEntries[Index]), *Lower, Lower.Len()); ++Index)
+		{
+			OutEntries.Add(SortedEntries[Index]);
+		}
+		OutEntries.Sort();
+		return;
+	}
+
+	TArray<uint64, TInlineAllocator<64>> Trigrams;
+	GetTrigrams(*Lower, Lower.Len(), Trigrams);
+
+	if (Trigrams.Num() == 0)
+	{
+		// One or two characters have no trigram to look up, these queries are rare and cheap to scan
+		for (int32 Entry = 0; Entry < TextStart.Num() - 1 && OutEntries.Num() < Cap; ++Entry)
+		{
+			if (FCString::Strstr(GetText(Entry), *Lower))
+			{
+				OutEntries.Add(Entry);
+			}
+		}
+		return;
+	}
+
+	if (Mode == EEventSearchMode::Substring)
+	{
+		TArray<TArrayView<const int32>, TInlineAllocator<64>> Lists;
+		for (uint64 Trigram : Trigrams)
+		{
+			TArrayView<const int32> List = GetPostings(Trigram);
+			if (List.Num() == 0)
+			{
+				return;
+			}
+			Lists.Add(List);
+		}
+		Lists.Sort([](const TArrayView<const int32>& A, const TArrayView<const int32>& B) { return A.Num() < B.Num(); });
+
+		// Walk the shortest list and binary search the others, then confirm the trigrams are contiguous in the right order
+		for (int32 Entry : Lists[0])
+		{
+			bool bInAll = true;
+			for (int32 ListIdx = 1; bInAll && ListIdx < Lists.Num(); ++ListIdx)
+			{
+				bInAll = Algo::BinarySearch(Lists[ListIdx], Entry) != INDEX_NONE;
+			}
+
+			if (bInAll && FCString::Strstr(GetText(Entry), *Lower))
+			{
+				OutEntries.Add(Entry);
+				if (OutEntries.Num() >= Cap)
+				{
+					break;
+				}
+			}
+		}
+		return;
+	}
+
+	// Fuzzy, rank by the share of trigrams the query and the name have in common
+	TMap<int32, int32> SharedCounts;
+	for (uint64 Trigram : Trigrams)
+	{
+		for (int32 Entry : GetPostings(Trigram))
+		{
+			++SharedCounts.FindOrAdd(Entry);
+		}
+	}
+
+	TArray<TPair<float, int32>> Scored;
+	Scored.Reserve(SharedCounts.Num());
+	for (const TPair<int32, int32>& Pair : SharedCounts)
+	{
+		const int32 NameTrigrams = FMath::Max(GetTextLen(Pair.Key) - 2, 1);
+		Scored.Emplace((float)Pair.Value / (Trigrams.Num() + NameTrigrams - Pair.Value), Pair.Key);
+	}
+	Scored.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key || (A.Key == B.Key && A.Value < B.Value); });
+
+	for (int32 Index = 0; Index < Scored.Num() && OutEntries.Num() < Cap; ++Index)
+	{
+		OutEntries.Add(Scored[Index].Value);
+	}
+}
+
+TArrayView<const int32> FEventSearchIndex::GetPostings(uint64 Trigram) const
+{
+	const TPair<int32, int32>* Range = TrigramRanges.Find(Trigram);
+	return Range ? TArrayView<const int32>(Postings.GetData() + Range->Key, Range->Value) : TArrayView<const int32>();
+}
+
+void FEventSearchIndex::GetTrigrams(const TCHAR* String, int32 Len, TArray<uint64, TInlineAllocator<64>>& OutTrigrams)
+{
+	OutTrigrams.Reset();
+	for (int32 Index = 0; Index + 2 < Len; ++Index)
+	{
+		OutTrigrams.Add(((uint64)(String[Index] & 0x1FFFFF) << 42) | ((uint64)(String[Index + 1] & 0x1FFFFF) << 21) | (uint64)(String[Index + 2] & 0x1FFFFF));
+	}
+	Algo::Sort(OutTrigrams);
+	OutTrigrams.SetNum(Algo::Unique(OutTrigrams), false);
+}
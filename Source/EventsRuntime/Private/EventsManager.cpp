@@ -5,7 +5,12 @@
 #include "HAL/PlatformFilemanager.h"
 #include "HAL/FileManager.h"
 #include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
 #include "Misc/ScopeLock.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Stats/StatsMisc.h"
 #include "Misc/ConfigCacheIni.h"
 #include "UObject/UObjectArray.h"
@@ -19,6 +24,7 @@
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Misc/CoreDelegates.h"
+#include "Containers/Ticker.h"
 
 #if WITH_EDITOR
 #include "SourceControlHelpers.h"
@@ -36,6 +42,23 @@ const FName UEventsManager::NAME_EventFilter("EventFilter");
 
 UEventsManager* UEventsManager::SingletonManager = nullptr;
 
+static int32 EventParallelSplitThreshold = 256;
+static FAutoConsoleVariableRef CVarEventParallelSplitThreshold(TEXT("Events.ParallelSplitThreshold"), EventParallelSplitThreshold, TEXT("Minimum number of rows in a tag source before its rows are split with ParallelFor"), ECVF_Default);
+
+
+/** Row pointers of a tag list, as taken by AddTagTableRows */
+template<typename RowType>
+static TArray<const FEventTableRow*> GetTagRowPointers(const TArray<RowType>& Rows)
+{
+	TArray<const FEventTableRow*> Pointers;
+	Pointers.Reserve(Rows.Num());
+	for (const RowType& Row : Rows)
+	{
+		Pointers.Add(&Row);
+	}
+	return Pointers;
+}
+
 UEventsManager::UEventsManager(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -63,12 +86,16 @@ void UEventsManager::LoadEventTables(bool bAllowAsyncLoad)
 	EventTables.Empty();
 
 #if !WITH_EDITOR
-	// If we're a cooked build and in a safe spot, start an async load so we can pipeline it
+	// If we're a cooked build and in a safe spot, start an async load so we can pipeline it.
+	// The tree is built without the tables and they are added once the last one arrives, slots keep the configured order
 	if (bAllowAsyncLoad && !IsLoading() && MutableDefault->EventTableList.Num() > 0)
 	{
-		for (FSoftObjectPath DataTablePath : MutableDefault->EventTableList)
+		bEventTablesReady = false;
+		EventTables.SetNumZeroed(MutableDefault->EventTableList.Num());
+		PendingEventTableLoads = MutableDefault->EventTableList.Num();
+		for (int32 TableIndex = 0; TableIndex < MutableDefault->EventTableList.Num(); ++TableIndex)
 		{
-			LoadPackageAsync(DataTablePath.GetLongPackageName());
+			LoadPackageAsync(MutableDefault->EventTableList[TableIndex].GetLongPackageName(), FLoadPackageAsyncDelegate::CreateUObject(this, &UEventsManager::OnEventTablePackageLoaded, TableIndex));
 		}
 
 		return;
@@ -95,6 +122,75 @@ void UEventsManager::LoadEventTables(bool bAllowAsyncLoad)
 	}
 }
 
+void UEventsManager::OnEventTablePackageLoaded(const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result, int32 TableIndex)
+{
+	const TArray<FSoftObjectPath>& EventTableList = GetDefault<UEventsSettings>()->EventTableList;
+	UDataTable* TagTable = nullptr;
+	if (Result == EAsyncLoadingResult::Succeeded && EventTableList.IsValidIndex(TableIndex))
+	{
+		TagTable = Cast<UDataTable>(EventTableList[TableIndex].ResolveObject());
+	}
+	UE_CLOG(!TagTable, LogEvents, Warning, TEXT("Failed to async load event table %s"), *PackageName.ToString());
+
+	if (EventTables.IsValidIndex(TableIndex))
+	{
+		EventTables[TableIndex] = TagTable;
+	}
+
+	if (--PendingEventTableLoads == 0)
+	{
+		FinishAsyncEventTableLoad();
+	}
+}
+
+void UEventsManager::FinishAsyncEventTableLoad()
+{
+	SCOPE_LOG_EventS(TEXT("UEventsManager::FinishAsyncEventTableLoad"));
+
+	// A tree constructed while the loads were in flight is missing the table rows, add them and publish it again.
+	// The redirects, common tags, net indices and dictionary are redone by the async build since they may name table rows
+	if (GameplayRootTag.IsValid())
+	{
+		for (UDataTable* DataTable : EventTables)
+		{
+			if (DataTable)
+			{
+				PopulateTreeFromDataTable(DataTable);
+			}
+		}
+		StartAsyncTreeBuild();
+	}
+
+	SetEventTablesReady();
+}
+
+void UEventsManager::SetEventTablesReady()
+{
+	if (!bEventTablesReady)
+	{
+		bEventTablesReady = true;
+		OnEventTablesReadyDelegate().Broadcast();
+	}
+}
+
+void UEventsManager::CallOrRegister_OnEventTablesReady(FSimpleMulticastDelegate::FDelegate Delegate)
+{
+	if (bEventTablesReady)
+	{
+		Delegate.Execute();
+	}
+	else
+	{
+		OnEventTablesReadyDelegate().Add(Delegate);
+	}
+}
+
+FSimpleMulticastDelegate& UEventsManager::OnEventTablesReadyDelegate()
+{
+	static FSimpleMulticastDelegate Delegate;
+	return Delegate;
+}
+
 struct FCompareFEventNodeByTag
 {
 	FORCEINLINE bool operator()( const TSharedPtr<FEventNode>& A, const TSharedPtr<FEventNode>& B ) const
@@ -124,11 +220,17 @@ void UEventsManager::AddTagIniSearchPath(const FString& RootDir)
 #if WITH_EDITOR
 			EditorRefreshEventTree();
 #else
+			EnsureEventTree();
+
 			AddTagsFromAdditionalLooseIniFiles(FilesInDirectory);
 
 			ConstructNetIndex();
 
+			RebuildDictionary();
+
 			IEventsModule::OnEventTreeChanged.Broadcast();
+
+			ReleaseEventTree();
 #endif
 		}
 	}
@@ -177,10 +279,7 @@ void UEventsManager::AddTagsFromAdditionalLooseIniFiles(const TArray<FString>& I
 			}
 #endif
 
-			for (const FEventTableRow& TableRow : FoundSource->SourceTagList->EventList)
-			{
-				AddTagTableRow(TableRow, TagSource);
-			}
+			AddTagTableRows(GetTagRowPointers(FoundSource->SourceTagList->EventList), TagSource);
 		}
 	}
 }
@@ -199,8 +298,15 @@ void UEventsManager::ConstructEventTree()
 		InvalidTagCharacters = MutableDefault->InvalidTagCharacters;
 		InvalidTagCharacters.Append(TEXT("\r\n\t"));
 
+		// Cooked builds start from the snapshot of the final tree when one was staged, the sources are then skipped
+		bool bFromSnapshot = false;
+		{
+			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: Load snapshot"));
+			bFromSnapshot = ConstructFromCookedSnapshot();
+		}
+
 		// Add prefixes first
-		if (ShouldImportTagsFromINI())
+		if (!bFromSnapshot && ShouldImportTagsFromINI())
 		{
 			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: ImportINI prefixes"));
 
@@ -231,10 +337,7 @@ void UEventsManager::ConstructEventTree()
 						FoundSource->SourceRestrictedTagList->SortTags();
 					}
 #endif
-					for (const FRestrictedEventTableRow& TableRow : FoundSource->SourceRestrictedTagList->RestrictedEventList)
-					{
-						AddTagTableRow(TableRow, TagSource, true);
-					}
+					AddTagTableRows(GetTagRowPointers(FoundSource->SourceRestrictedTagList->RestrictedEventList), TagSource, true);
 				}
 			}
 		}
@@ -248,12 +351,13 @@ void UEventsManager::ConstructEventTree()
 		}
 		}
 
-		// If we didn't load any tables it might be async loading, so load again with a flush
-		if (EventTables.Num() == 0)
+		// Tables that are still async loading are added when they finish, only load synchronously if nothing was started
+		if (!bFromSnapshot && EventTables.Num() == 0 && PendingEventTableLoads == 0)
 		{
 			LoadEventTables(false);
 		}
 		
+		if (!bFromSnapshot)
 			{
 			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: Construct from data asset"));
 			for (UDataTable* DataTable : EventTables)
@@ -268,7 +372,7 @@ void UEventsManager::ConstructEventTree()
 		// Create native source
 		FindOrAddTagSource(FEventSource::GetNativeName(), EEventSourceType::Native);
 
-		if (ShouldImportTagsFromINI())
+		if (!bFromSnapshot && ShouldImportTagsFromINI())
 		{
 			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: ImportINI tags"));
 
@@ -297,10 +401,7 @@ void UEventsManager::ConstructEventTree()
 			FName TagSource = FEventSource::GetDefaultName();
 			FEventSource* DefaultSource = FindOrAddTagSource(TagSource, EEventSourceType::DefaultTagList);
 
-			for (const FEventTableRow& TableRow : MutableDefault->EventList)
-			{
-				AddTagTableRow(TableRow, TagSource);
-			}
+			AddTagTableRows(GetTagRowPointers(MutableDefault->EventList), TagSource);
 
 			// Extra tags
 			AddTagIniSearchPath(FPaths::ProjectConfigDir() / TEXT("Events"));
@@ -317,19 +418,7 @@ void UEventsManager::ConstructEventTree()
 		{
 			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: Request common events"));
 		// Grab the commonly replicated tags
-		CommonlyReplicatedTags.Empty();
-		for (FName TagName : MutableDefault->CommonlyReplicatedTags)
-		{
-			FEventInfo Tag = RequestEvent(TagName);
-			if (Tag.IsValid())
-			{
-				CommonlyReplicatedTags.Add(Tag);
-			}
-			else
-			{
-				UE_LOG(LogEvents, Warning, TEXT("%s was found in the CommonlyReplicatedEvents list but doesn't appear to be a valid event!"), *TagName.ToString());
-			}
-		}
+		ResolveCommonlyReplicatedTags();
 
 		bUseFastReplication = MutableDefault->FastReplication;
 		bShouldWarnOnInvalidTags = MutableDefault->WarnOnInvalidTags;
@@ -340,7 +429,28 @@ void UEventsManager::ConstructEventTree()
 		if (ShouldUseFastReplication())
 		{
 			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: Reconstruct NetIndex"));
-			ConstructNetIndex();
+
+			// Snapshot net indices are only valid if no native tag was missing from it
+			const FEventDictionarySnapshot* Snapshot = bFromSnapshot ? GetCookedSnapshot() : nullptr;
+			if (Snapshot && Snapshot->GetHeader().bHasNetIndices && (uint32)EventNodeMap.Num() == Snapshot->GetHeader().NumEntries)
+			{
+				InvalidTagNetIndex = NetworkEventNodeIndex.Num() + 1;
+				NetIndexTrueBitNum = FMath::CeilToInt(FMath::Log2(InvalidTagNetIndex));
+				NetIndexFirstBitSegment = FMath::Min<int64>(NetIndexFirstBitSegment, NetIndexTrueBitNum);
+				NetworkEventNodeIndexHash = Snapshot->GetHeader().NetworkHash;
+
+				// The snapshot was written from the same ini, so its common tags lead the same way
+				NumCommonNetIndices = FMath::Min(CommonlyReplicatedTags.Num(), NetworkEventNodeIndex.Num());
+			}
+			else
+			{
+				ConstructNetIndex();
+			}
+		}
+
+		{
+			SCOPE_LOG_EventS(TEXT("UEventsManager::ConstructEventTree: Flatten dictionary"));
+			RebuildDictionary();
 		}
 
 		{
@@ -388,71 +498,129 @@ void UEventsManager::ConstructEventTree()
 			UE_LOG(LogEvents, Log, TEXT("EventRedirects is in a deprecated location, after editing Events developer settings you must remove these manually"));
 		}
 
-		// Check settings object
-		for (const FEventRedirect& Redirect : MutableDefault->EventRedirects)
+		CompileTagRedirects(MutableDefault->EventRedirects);
+	}
+
+		if (PendingEventTableLoads == 0)
 		{
-			FName OldTagName = Redirect.OldTagName;
-			FName NewTagName = Redirect.NewTagName;
+			SetEventTablesReady();
+		}
+	}
+}
 
-			if (ensureMsgf(!TagRedirects.Contains(OldTagName), TEXT("Old event %s is being redirected to more than one event. Please remove all the redirections except for one."), *OldTagName.ToString()))
-			{
-				FEventInfo OldTag = RequestEvent(OldTagName, false); //< This only succeeds if OldTag is in the Table!
-				if (OldTag.IsValid())
-				{
-					FEventContainer MatchingChildren = RequestEventChildren(OldTag);
+void UEventsManager::CompileTagRedirects(const TArray<FEventRedirect>& Redirects)
+{
+	TagRedirects.Reset();
 
-					FString Msg = FString::Printf(TEXT("Old event (%s) which is being redirected still exists in the table!  Generally you should "
-						TEXT("remove the old events from the table when you are redirecting to new events, or else users will ")
-						TEXT("still be able to add the old events to containers.")), *OldTagName.ToString());
+	TMap<FName, FName> NextName;
+	NextName.Reserve(Redirects.Num());
+	for (const FEventRedirect& Redirect : Redirects)
+	{
+		if (ensureMsgf(!NextName.Contains(Redirect.OldTagName), TEXT("Old event %s is being redirected to more than one event. Please remove all the redirections except for one."), *Redirect.OldTagName.ToString()))
+		{
+			NextName.Add(Redirect.OldTagName, Redirect.NewTagName);
+		}
+	}
 
-					if (MatchingChildren.Num() == 0)
-					{
-						UE_LOG(LogEvents, Warning, TEXT("%s"), *Msg);
-					}
-					else
-					{
-						Msg += TEXT("\nSuppressed warning due to redirected event being a single component that matched other hierarchy elements.");
-						UE_LOG(LogEvents, Log, TEXT("%s"), *Msg);
-					}
-				}
+	// Each chain is followed once, every name on it gets the final target so loading needs a single lookup
+	TMap<FName, FEventInfo> Resolved;
+	TArray<FName> Chain;
+	for (const TPair<FName, FName>& Redirect : NextName)
+	{
+		const FName OldTagName = Redirect.Key;
 
-				FEventInfo NewTag = (NewTagName != NAME_None) ? RequestEvent(NewTagName, false) : FEventInfo();
+		FEventInfo OldTag = RequestEvent(OldTagName, false); //< This only succeeds if OldTag is in the Table!
+		if (OldTag.IsValid())
+		{
+			FEventContainer MatchingChildren = RequestEventChildren(OldTag);
 
-				// Basic infinite recursion guard
-				int32 IterationsLeft = 10;
-				while (!NewTag.IsValid() && NewTagName != NAME_None)
-				{
-					bool bFoundRedirect = false;
+			FString Msg = FString::Printf(TEXT("Old event (%s) which is being redirected still exists in the table!  Generally you should "
+				TEXT("remove the old events from the table when you are redirecting to new events, or else users will ")
+				TEXT("still be able to add the old events to containers.")), *OldTagName.ToString());
 
-					// See if it got redirected again
-					for (const FEventRedirect& SecondRedirect : MutableDefault->EventRedirects)
-					{
-						if (SecondRedirect.OldTagName == NewTagName)
-						{
-							NewTagName = SecondRedirect.NewTagName;
-							NewTag = RequestEvent(NewTagName, false);
-							bFoundRedirect = true;
-							break;
-						}
-					}
-					IterationsLeft--;
+			if (MatchingChildren.Num() == 0)
+			{
+				UE_LOG(LogEvents, Warning, TEXT("%s"), *Msg);
+			}
+			else
+			{
+				Msg += TEXT("\nSuppressed warning due to redirected event being a single component that matched other hierarchy elements.");
+				UE_LOG(LogEvents, Log, TEXT("%s"), *Msg);
+			}
+		}
 
-					if (!bFoundRedirect || IterationsLeft <= 0)
-					{
-						UE_LOG(LogEvents, Warning, TEXT("Invalid new event %s! Cannot replace old event %s."),
-							*Redirect.NewTagName.ToString(), *Redirect.OldTagName.ToString());
-						break;
-					}
-				}
+		// Follow the chain while the target isn't a real tag but is redirected again
+		Chain.Reset();
+		Chain.Add(OldTagName);
+		FName NewTagName = Redirect.Value;
+		FEventInfo NewTag;
+		bool bFailed = false;
+		while (true)
+		{
+			NewTag = (NewTagName != NAME_None) ? RequestEvent(NewTagName, false) : FEventInfo();
+			if (NewTag.IsValid())
+			{
+				break;
+			}
 
-				if (NewTag.IsValid())
-				{
-					// Populate the map
-					TagRedirects.Add(OldTagName, NewTag);
-				}
+			if (const FEventInfo* Known = Resolved.Find(NewTagName))
+			{
+				NewTag = *Known;
+				break;
+			}
+
+			const FName* Next = NextName.Find(NewTagName);
+			if (!Next)
+			{
+				break;
+			}
+
+			if (Chain.Contains(NewTagName))
+			{
+				Chain.Add(NewTagName);
+				UE_LOG(LogEvents, Error, TEXT("Event redirects form a cycle: %s. Cannot replace old event %s."), *FString::JoinBy(Chain, TEXT(" -> "), [](FName Name) { return Name.ToString(); }), *OldTagName.ToString());
+				bFailed = true;
+				break;
 			}
+			Chain.Add(NewTagName);
+			NewTagName = *Next;
+		}
+
+		if (!bFailed && !NewTag.IsValid())
+		{
+			UE_LOG(LogEvents, Warning, TEXT("Invalid new event %s! Cannot replace old event %s."), *Redirect.Value.ToString(), *OldTagName.ToString());
+		}
+
+		for (FName ChainName : Chain)
+		{
+			Resolved.Add(ChainName, NewTag);
+		}
+
+		if (NewTag.IsValid())
+		{
+			// Populate the map
+			TagRedirects.Add(OldTagName, NewTag);
 		}
 	}
+}
+
+void UEventsManager::ResolveCommonlyReplicatedTags()
+{
+	// Tags from tables still loading resolve once they arrive, FinishAsyncEventTableLoad calls this again
+	const bool bTablesLoaded = PendingEventTableLoads == 0;
+
+	CommonlyReplicatedTags.Empty();
+	for (FName TagName : GetDefault<UEventsSettings>()->CommonlyReplicatedTags)
+	{
+		FEventInfo Tag = RequestEvent(TagName, bTablesLoaded);
+		if (Tag.IsValid())
+		{
+			CommonlyReplicatedTags.AddUnique(Tag);
+		}
+		else if (bTablesLoaded)
+		{
+			UE_LOG(LogEvents, Warning, TEXT("%s was found in the CommonlyReplicatedEvents list but doesn't appear to be a valid event!"), *TagName.ToString());
+		}
 	}
 }
 
@@ -460,35 +628,42 @@ int32 ESPrintNetIndiceAssignment = 0;
 static FAutoConsoleVariableRef CVarESPrintNetIndiceAssignment(TEXT("Events.ESPrintNetIndiceAssignment"), ESPrintNetIndiceAssignment, TEXT("Logs Event NetIndice assignment"), ECVF_Default );
 void UEventsManager::ConstructNetIndex()
 {
-	NetworkEventNodeIndex.Empty();
+	GatherNetIndexOrder(NetworkEventNodeIndex, NumCommonNetIndices);
+	AssignNetIndices(0);
+}
 
-	EventNodeMap.GenerateValueArray(NetworkEventNodeIndex);
+void UEventsManager::GatherNetIndexOrder(TArray<TSharedPtr<FEventNode>>& OutOrder, int32& OutNumCommon) const
+{
+	OutOrder.Reset(EventNodeMap.Num());
 
-	NetworkEventNodeIndex.Sort(FCompareFEventNodeByTag());
+	// Common tags go first in their configured order
+	TSet<const FEventNode*> CommonNodes;
+	CommonNodes.Reserve(CommonlyReplicatedTags.Num());
+	for (const FEventInfo& Tag : CommonlyReplicatedTags)
+	{
+		TSharedPtr<FEventNode> Node = FindTagNode(Tag);
 
-	check(CommonlyReplicatedTags.Num() <= NetworkEventNodeIndex.Num());
+		// A non fatal error should have been thrown when parsing the CommonlyReplicatedTags list. If we make it here, something is seriously wrong.
+		checkf(Node.IsValid(), TEXT("Event %s not found in NetworkEventNodeIndex"), *Tag.ToString());
 
-	// Put the common indices up front
-	for (int32 CommonIdx=0; CommonIdx < CommonlyReplicatedTags.Num(); ++CommonIdx)
-	{
-		int32 BaseIdx=0;
-		FEventInfo& Tag = CommonlyReplicatedTags[CommonIdx];
+		CommonNodes.Add(Node.Get());
+		OutOrder.Add(Node);
+	}
+	OutNumCommon = OutOrder.Num();
 
-		bool Found = false;
-		for (int32 findidx=0; findidx < NetworkEventNodeIndex.Num(); ++findidx)
+	// The rest follows sorted by name, map order isn't deterministic but the sort is since names are unique
+	for (const TPair<FEventInfo, TSharedPtr<FEventNode>>& Pair : EventNodeMap)
+	{
+		if (!CommonNodes.Contains(Pair.Value.Get()))
 		{
-			if (NetworkEventNodeIndex[findidx]->GetCompleteTag() == Tag)
-			{
-				NetworkEventNodeIndex.Swap(findidx, CommonIdx);
-				Found = true;
-				break;
-			}
+			OutOrder.Add(Pair.Value);
 		}
-
-		// A non fatal error should have been thrown when parsing the CommonlyReplicatedTags list. If we make it here, something is seriously wrong.
-		checkf( Found, TEXT("Event %s not found in NetworkEventNodeIndex"), *Tag.ToString() );
 	}
+	Algo::Sort(MakeArrayView(OutOrder).Slice(OutNumCommon, OutOrder.Num() - OutNumCommon), FCompareFEventNodeByTag());
+}
 
+void UEventsManager::AssignNetIndices(int32 FirstIndex)
+{
 	InvalidTagNetIndex = NetworkEventNodeIndex.Num()+1;
 	NetIndexTrueBitNum = FMath::CeilToInt(FMath::Log2(InvalidTagNetIndex));
 	
@@ -501,6 +676,7 @@ void UEventsManager::ConstructNetIndex()
 		ensureMsgf(false, TEXT("Too many events in dictionary for networking! Remove events or increase event net index size"));
 
 		NetworkEventNodeIndex.SetNum(INVALID_TAGNETINDEX - 1);
+		NumCommonNetIndices = FMath::Min(NumCommonNetIndices, NetworkEventNodeIndex.Num());
 	}
 
 	UE_CLOG(ESPrintNetIndiceAssignment, LogEvents, Display, TEXT("Assigning NetIndices to %d events."), NetworkEventNodeIndex.Num() );
@@ -511,11 +687,15 @@ void UEventsManager::ConstructNetIndex()
 	{
 		if (NetworkEventNodeIndex[i].IsValid())
 		{
-			NetworkEventNodeIndex[i]->NetIndex = i;
+			// The hash chains over every tag, only the numbering can start late
+			if (i >= FirstIndex)
+			{
+				NetworkEventNodeIndex[i]->NetIndex = i;
 
-			NetworkEventNodeIndexHash = FCrc::StrCrc32(*NetworkEventNodeIndex[i]->GetCompleteTagString().ToLower(), NetworkEventNodeIndexHash);
+				UE_CLOG(ESPrintNetIndiceAssignment, LogEvents, Display, TEXT("Assigning NetIndex (%d) to Event (%s)"), i, *NetworkEventNodeIndex[i]->GetCompleteTag().ToString());
+			}
 
-			UE_CLOG(ESPrintNetIndiceAssignment, LogEvents, Display, TEXT("Assigning NetIndex (%d) to Event (%s)"), i, *NetworkEventNodeIndex[i]->GetCompleteTag().ToString());
+			NetworkEventNodeIndexHash = FCrc::StrCrc32(*NetworkEventNodeIndex[i]->GetCompleteTagString().ToLower(), NetworkEventNodeIndexHash);
 		}
 		else
 		{
@@ -526,107 +706,454 @@ void UEventsManager::ConstructNetIndex()
 	UE_LOG(LogEvents, Log, TEXT("NetworkEventNodeIndexHash is %x"), NetworkEventNodeIndexHash);
 }
 
-FName UEventsManager::GetTagNameFromNetIndex(FEventNetIndex Index) const
+const FEventDictionarySnapshot* UEventsManager::GetCookedSnapshot()
 {
-	if (Index >= NetworkEventNodeIndex.Num())
+	if (!bCookedSnapshotOpened)
 	{
-		// Ensure Index is the invalid index. If its higher than that, then something is wrong.
-		ensureMsgf(Index == InvalidTagNetIndex, TEXT("Received invalid event net index %d! Event index is out of sync on client!"), Index);
-		return NAME_None;
+		bCookedSnapshotOpened = true;
+		if (FPlatformProperties::RequiresCookedData())
+		{
+			CookedSnapshot = FEventDictionarySnapshot::Open(FEventDictionarySnapshot::GetDefaultFilename());
+		}
 	}
-	return NetworkEventNodeIndex[Index]->GetCompleteTagName();
+	return CookedSnapshot.Get();
 }
 
-FEventNetIndex UEventsManager::GetNetIndexFromTag(const FEventInfo &InTag) const
+uint32 UEventsManager::GetIniSourceHash() const
 {
-	TSharedPtr<FEventNode> EventNode = FindTagNode(InTag);
+	TArray<FString> Files;
+	GetRestrictedTagConfigFiles(Files);
+	IFileManager::Get().FindFilesRecursive(Files, *(FPaths::ProjectConfigDir() / TEXT("Events")), TEXT("*.ini"), true, false, false);
+	Files.Sort();
+	Files.Insert(GetDefault<UEventsSettings>()->GetDefaultConfigFilename(), 0);
 
-	if (EventNode.IsValid())
+	// Staged builds see the files under other paths, only their names and contents count
+	uint32 Hash = 0;
+	for (const FString& File : Files)
 	{
-		return EventNode->GetNetIndex();
+		FString Contents;
+		if (FFileHelper::LoadFileToString(Contents, *File))
+		{
+			Hash = FCrc::StrCrc32(*FPaths::GetCleanFilename(File), Hash);
+			Hash = FCrc::StrCrc32(*Contents, Hash);
+		}
 	}
 
-	return InvalidTagNetIndex;
+	for (const FSoftObjectPath& TablePath : GetDefault<UEventsSettings>()->EventTableList)
+	{
+		Hash = FCrc::StrCrc32(*TablePath.ToString(), Hash);
+	}
+	return Hash;
 }
 
-bool UEventsManager::ShouldImportTagsFromINI() const
+uint32 UEventsManager::GetEventTableHash() const
 {
-	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
-
-	// Deprecated path
-	bool ImportFromINI = false;
-	if (GConfig->GetBool(TEXT("Events"), TEXT("ImportTagsFromConfig"), ImportFromINI, GEngineIni))
+	// Hashes what the rows declare rather than the packages, cooking changes the package bytes but not the rows
+	uint32 Hash = 0;
+	for (const UDataTable* DataTable : EventTables)
 	{
-		if (ImportFromINI)
+		if (!DataTable || !DataTable->GetRowStruct() || !DataTable->GetRowStruct()->IsChildOf(FEventTableRow::StaticStruct()))
 		{
-			MutableDefault->ImportTagsFromConfig = ImportFromINI;
-			UE_LOG(LogEvents, Log, TEXT("ImportTagsFromConfig is in a deprecated location, open and save Event settings to fix"));
+			continue;
 		}
-		return ImportFromINI;
-	}
 
-	return MutableDefault->ImportTagsFromConfig;
+		for (const TPair<FName, uint8*>& Pair : DataTable->GetRowMap())
+		{
+			const FEventTableRow& Row = *(const FEventTableRow*)Pair.Value;
+			Hash = FCrc::StrCrc32(*Row.Tag.ToString(), Hash);
+			for (const FEventParameter& Parameter : Row.Parameters)
+			{
+				Hash = FCrc::StrCrc32(*Parameter.Name.ToString(), Hash);
+				Hash = FCrc::StrCrc32(*Parameter.Type.ToString(), Hash);
+			}
+
+			const uint8 Flags = (Row.Throttle.bDeliverTrailing ? 1 : 0) | ((uint8)Row.Replication << 1);
+			Hash = FCrc::MemCrc32(&Row.Throttle.MaxRate, sizeof(Row.Throttle.MaxRate), Hash);
+			Hash = FCrc::MemCrc32(&Row.Throttle.MinInterval, sizeof(Row.Throttle.MinInterval), Hash);
+			Hash = FCrc::MemCrc32(&Flags, sizeof(Flags), Hash);
+		}
+	}
+	return Hash;
 }
 
-void UEventsManager::GetRestrictedTagConfigFiles(TArray<FString>& RestrictedConfigFiles) const
+bool UEventsManager::ConstructFromCookedSnapshot()
 {
-	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
+	const FEventDictionarySnapshot* Snapshot = GetCookedSnapshot();
+	if (!Snapshot)
+	{
+		return false;
+	}
 
-	if (MutableDefault)
+	const FEventDictionarySnapshot::FHeader& Header = Snapshot->GetHeader();
+	const FEventDictionarySnapshot::FEntry* Entries = Snapshot->GetEntries();
+	const FEventDictionarySnapshot::FParameter* Parameters = Snapshot->GetParameters();
+
+	TArray<TSharedPtr<FEventNode>> Nodes;
+	Nodes.Reserve(Header.NumEntries);
+	EventNodeMap.Reserve(Header.NumEntries);
+	NetworkEventNodeIndex.Reset();
+	if (Header.bHasNetIndices)
 	{
-		for (const FEventRestrictedConfigInfo& Config : MutableDefault->RestrictedConfigFiles)
+		NetworkEventNodeIndex.SetNum(Header.NumEntries);
+	}
+
+	// Entries are in pre-order with sorted siblings, so each node is simply appended to its parent
+	for (uint32 Index = 0; Index < Header.NumEntries; ++Index)
+	{
+		const FEventDictionarySnapshot::FEntry& Entry = Entries[Index];
+		TSharedPtr<FEventNode> ParentNode = Entry.Parent != INDEX_NONE ? Nodes[Entry.Parent] : TSharedPtr<FEventNode>();
+
+		TSharedPtr<FEventNode> TagNode = MakeShareable(new FEventNode(FName(UTF8_TO_TCHAR(Snapshot->GetString(Entry.SimpleName))), FName(UTF8_TO_TCHAR(Snapshot->GetString(Entry.CompleteName))), ParentNode, true, false, true));
+		TagNode->Throttle.MaxRate = Entry.MaxRate;
+		TagNode->Throttle.MinInterval = Entry.MinInterval;
+		TagNode->Throttle.bDeliverTrailing = Entry.bDeliverTrailing != 0;
+		TagNode->Replication = (EEventReplicationPolicy)Entry.Replication;
+
+		TagNode->Parameters.SetNum(Entry.NumParameters);
+		for (int32 ParamIdx = 0; ParamIdx < Entry.NumParameters; ++ParamIdx)
 		{
-			RestrictedConfigFiles.Add(FString::Printf(TEXT("%sEvents/%s"), *FPaths::SourceConfigDir(), *Config.RestrictedConfigName));
+			const FEventDictionarySnapshot::FParameter& Parameter = Parameters[Entry.FirstParameter + ParamIdx];
+			TagNode->Parameters[ParamIdx].Name = FName(UTF8_TO_TCHAR(Snapshot->GetString(Parameter.Name)));
+			TagNode->Parameters[ParamIdx].Type = FName(UTF8_TO_TCHAR(Snapshot->GetString(Parameter.Type)));
+		}
+
+		if (Header.bHasNetIndices && NetworkEventNodeIndex.IsValidIndex(Entry.NetIndex))
+		{
+			TagNode->NetIndex = Entry.NetIndex;
+			NetworkEventNodeIndex[Entry.NetIndex] = TagNode;
 		}
+
+		(ParentNode.IsValid() ? ParentNode : GameplayRootTag)->GetChildTagNodes().Add(TagNode);
+		EventNodeMap.Add(TagNode->GetCompleteTag(), TagNode);
+		Nodes.Add(MoveTemp(TagNode));
 	}
+
+	bDictionaryDirty = true;
+	UE_LOG(LogEvents, Log, TEXT("Constructed %d events from the cooked dictionary snapshot"), Header.NumEntries);
+	return true;
 }
 
-void UEventsManager::GetRestrictedTagSources(TArray<const FEventSource*>& Sources) const
+void UEventsManager::RebuildDictionary()
 {
-	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
-
-	if (MutableDefault)
+	// Only the game thread changes the tree, so it can be read here while other threads read the published dictionary
+	FEventDictionary* NewDictionary = new FEventDictionary();
+	if (GameplayRootTag.IsValid())
 	{
-		for (const FEventRestrictedConfigInfo& Config : MutableDefault->RestrictedConfigFiles)
-		{
-			const FEventSource* Source = FindTagSource(*Config.RestrictedConfigName);
-			if (Source)
-			{
-				Sources.Add(Source);
-			}
-		}
+		NewDictionary->Build(*GameplayRootTag, ++DictionaryGeneration);
 	}
+	PublishDictionary(NewDictionary);
 }
 
-void UEventsManager::GetOwnersForTagSource(const FString& SourceName, TArray<FString>& OutOwners) const
+void UEventsManager::PublishDictionary(const FEventDictionary* NewDictionary)
 {
-	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
-
-	if (MutableDefault)
+	// Other threads may be in the middle of a lookup in the old dictionary, it is freed once they can't be
+	if (const FEventDictionary* OldDictionary = PublishedDictionary.Exchange(NewDictionary))
 	{
-		for (const FEventRestrictedConfigInfo& Config : MutableDefault->RestrictedConfigFiles)
+		RetiredDictionaries.Add({ OldDictionary, GFrameCounter });
+		if (!ReclaimTickHandle.IsValid())
 		{
-			if (Config.RestrictedConfigName.Equals(SourceName))
-			{
-				OutOwners = Config.Owners;
-				return;
-			}
+			ReclaimTickHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UEventsManager::ReclaimRetiredDictionaries));
 		}
 	}
+	bDictionaryDirty = false;
 }
 
-void UEventsManager::EventContainerLoaded(FEventContainer& Container, FProperty* SerializingProperty) const
+void UEventsManager::StartAsyncTreeBuild()
 {
-	RedirectTagsForContainer(Container, SerializingProperty);
+	check(IsInGameThread());
+	EnsureEventTree();
 
-	if (OnEventLoadedDelegate.IsBound())
+	// Redirects and common tags may name native tags or table rows that weren't in the tree before
+	CompileTagRedirects(GetDefault<UEventsSettings>()->EventRedirects);
+	ResolveCommonlyReplicatedTags();
+
+	// Everything that changes the tree finishes the build first, so the worker reads a tree nothing writes
+	const FEventNode* Root = GameplayRootTag.Get();
+	const uint16 Generation = ++DictionaryGeneration;
+	const bool bNetIndices = ShouldUseFastReplication();
+	TUniqueFunction<FAsyncTreeBuild*()> Build = [this, Root, Generation, bNetIndices]()
 	{
-		for (const FEventInfo& Tag : Container)
+		FAsyncTreeBuild* Result = new FAsyncTreeBuild();
+		if (bNetIndices)
 		{
-			OnEventLoadedDelegate.Broadcast(Tag);
+			GatherNetIndexOrder(Result->NetOrder, Result->NumCommon);
+		}
+		Result->Dictionary.Reset(new FEventDictionary());
+		if (Root)
+		{
+			Result->Dictionary->Build(*Root, Generation, Result->NetOrder);
 		}
+		return Result;
+	};
+
+	if (WITH_EDITOR || !FPlatformProcess::SupportsMultithreading())
+	{
+		// The editor and commandlets read the final tree right after DoneAddingNativeTags
+		TPromise<FAsyncTreeBuild*> Promise;
+		Promise.SetValue(Build());
+		AsyncTreeBuild = Promise.GetFuture();
+		FinishAsyncTreeBuild();
+		return;
 	}
-}
+
+	TWeakObjectPtr<UEventsManager> WeakThis(this);
+	AsyncTreeBuild = Async(EAsyncExecution::ThreadPool, MoveTemp(Build), [WeakThis]()
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis]()
+		{
+			if (UEventsManager* Manager = WeakThis.Get())
+			{
+				Manager->FinishAsyncTreeBuild();
+			}
+		});
+	});
+}
+
+void UEventsManager::FinishAsyncTreeBuild()
+{
+	if (!AsyncTreeBuild.IsValid())
+	{
+		return;
+	}
+
+	// Blocks only when something has to change the tree before the worker is done
+	TUniquePtr<FAsyncTreeBuild> Result(AsyncTreeBuild.Get());
+	AsyncTreeBuild = TFuture<FAsyncTreeBuild*>();
+
+	if (ShouldUseFastReplication())
+	{
+		NetworkEventNodeIndex = MoveTemp(Result->NetOrder);
+		NumCommonNetIndices = Result->NumCommon;
+		AssignNetIndices(0);
+	}
+	PublishDictionary(Result->Dictionary.Release());
+
+	IEventsModule::OnEventTreeChanged.Broadcast();
+
+	if (bDoneAddingNativeTags && PendingEventTableLoads == 0 && !bNativeTagTreeReady)
+	{
+		bNativeTagTreeReady = true;
+		OnDoneAddingNativeTagsDelegate().Broadcast();
+	}
+
+	ReleaseEventTree();
+}
+
+void UEventsManager::EnsureEventTree()
+{
+	FinishAsyncTreeBuild();
+	RestoreEventTree();
+}
+
+void UEventsManager::ReleaseEventTree()
+{
+#if !WITH_EDITOR
+	// The editor edits the tree in place, cooked builds only need it again if something changes the events later
+	if (bNativeTagTreeReady && GameplayRootTag.IsValid() && !AsyncTreeBuild.IsValid() && !bIsConstructingEventTree && !bDictionaryDirty.Load(EMemoryOrder::Relaxed))
+	{
+		// Children and parents point at each other, the links have to be cut for the nodes to be freed
+		GameplayRootTag->ResetNode();
+		GameplayRootTag.Reset();
+		EventNodeMap.Empty();
+		NetworkEventNodeIndex.Empty();
+		UnsortedParents.Empty();
+		bEventTreeReleased = true;
+	}
+#endif
+}
+
+void UEventsManager::RestoreEventTree()
+{
+	if (!bEventTreeReleased)
+	{
+		return;
+	}
+	bEventTreeReleased = false;
+
+	const FEventDictionary* FlatDictionary = PublishedDictionary.Load();
+	check(FlatDictionary);
+
+	TArray<TSharedPtr<FEventNode>> Nodes;
+	Nodes.Reserve(FlatDictionary->Num());
+	GameplayRootTag = MakeShareable(new FEventNode());
+	EventNodeMap.Reserve(FlatDictionary->Num());
+	NetworkEventNodeIndex.Reset();
+	if (ShouldUseFastReplication())
+	{
+		NetworkEventNodeIndex.SetNum(InvalidTagNetIndex - 1);
+	}
+
+	// Same walk as ConstructFromCookedSnapshot, a parent always comes before its children
+	for (int32 Index = 0; Index < FlatDictionary->Num(); ++Index)
+	{
+		const int32 Parent = FlatDictionary->GetParent(Index);
+		TSharedPtr<FEventNode> ParentNode = Parent != INDEX_NONE ? Nodes[Parent] : TSharedPtr<FEventNode>();
+
+		TSharedPtr<FEventNode> TagNode = MakeShareable(new FEventNode(FlatDictionary->GetSimpleTagName(Index), FlatDictionary->GetTagName(Index), ParentNode, true, false, true));
+		const FEventEntryData& Data = FlatDictionary->GetEntryData(Index);
+		TagNode->Throttle = Data.Throttle;
+		TagNode->Replication = Data.Replication;
+		TagNode->Parameters.SetNum(Data.Parameters.Num());
+		for (int32 ParamIdx = 0; ParamIdx < Data.Parameters.Num(); ++ParamIdx)
+		{
+			TagNode->Parameters[ParamIdx].Name = Data.Parameters[ParamIdx].Name;
+			TagNode->Parameters[ParamIdx].Type = FName(*Data.Parameters[ParamIdx].Type);
+		}
+
+		const FEventNetIndex NetIndex = FlatDictionary->GetNetIndex(Index);
+		if (NetworkEventNodeIndex.IsValidIndex(NetIndex))
+		{
+			TagNode->NetIndex = NetIndex;
+			NetworkEventNodeIndex[NetIndex] = TagNode;
+		}
+
+		(ParentNode.IsValid() ? ParentNode : GameplayRootTag)->GetChildTagNodes().Add(TagNode);
+		EventNodeMap.Add(TagNode->GetCompleteTag(), TagNode);
+		Nodes.Add(MoveTemp(TagNode));
+	}
+}
+
+bool UEventsManager::ReclaimRetiredDictionaries(float DeltaTime)
+{
+	RetiredDictionaries.RemoveAll([](const FRetiredDictionary& Retired)
+	{
+		if (GFrameCounter - Retired.RetiredFrame < DictionaryGraceFrames)
+		{
+			return false;
+		}
+		delete Retired.Dictionary;
+		return true;
+	});
+
+	if (RetiredDictionaries.Num() == 0)
+	{
+		ReclaimTickHandle.Reset();
+		return false;
+	}
+	return true;
+}
+
+FName UEventsManager::GetTagNameFromNetIndex(FEventNetIndex Index) const
+{
+	if (const FEventDictionaryPtr FlatDictionary = GetDictionary())
+	{
+		const int32 Entry = FlatDictionary->FindByNetIndex(Index);
+		if (Entry != INDEX_NONE)
+		{
+			return FlatDictionary->GetTagName(Entry);
+		}
+
+		// The tree may be released, the dictionary has every net index
+		ensureMsgf(Index == InvalidTagNetIndex, TEXT("Received invalid event net index %d! Event index is out of sync on client!"), Index);
+		return NAME_None;
+	}
+
+	if (Index >= NetworkEventNodeIndex.Num())
+	{
+		// Ensure Index is the invalid index. If its higher than that, then something is wrong.
+		ensureMsgf(Index == InvalidTagNetIndex, TEXT("Received invalid event net index %d! Event index is out of sync on client!"), Index);
+		return NAME_None;
+	}
+	return NetworkEventNodeIndex[Index]->GetCompleteTagName();
+}
+
+FEventNetIndex UEventsManager::GetNetIndexFromTag(const FEventInfo &InTag) const
+{
+	FEventDictionaryPtr FlatDictionary;
+	const FEventNodeView View = FindTagView(InTag, FlatDictionary);
+	if (View.IsValid() && View.GetNetIndex() != INVALID_TAGNETINDEX)
+	{
+		return View.GetNetIndex();
+	}
+
+	TSharedPtr<FEventNode> EventNode = FindTagNode(InTag);
+
+	if (EventNode.IsValid())
+	{
+		return EventNode->GetNetIndex();
+	}
+
+	return InvalidTagNetIndex;
+}
+
+bool UEventsManager::ShouldImportTagsFromINI() const
+{
+	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
+
+	// Deprecated path
+	bool ImportFromINI = false;
+	if (GConfig->GetBool(TEXT("Events"), TEXT("ImportTagsFromConfig"), ImportFromINI, GEngineIni))
+	{
+		if (ImportFromINI)
+		{
+			MutableDefault->ImportTagsFromConfig = ImportFromINI;
+			UE_LOG(LogEvents, Log, TEXT("ImportTagsFromConfig is in a deprecated location, open and save Event settings to fix"));
+		}
+		return ImportFromINI;
+	}
+
+	return MutableDefault->ImportTagsFromConfig;
+}
+
+void UEventsManager::GetRestrictedTagConfigFiles(TArray<FString>& RestrictedConfigFiles) const
+{
+	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
+
+	if (MutableDefault)
+	{
+		for (const FEventRestrictedConfigInfo& Config : MutableDefault->RestrictedConfigFiles)
+		{
+			RestrictedConfigFiles.Add(FString::Printf(TEXT("%sEvents/%s"), *FPaths::SourceConfigDir(), *Config.RestrictedConfigName));
+		}
+	}
+}
+
+void UEventsManager::GetRestrictedTagSources(TArray<const FEventSource*>& Sources) const
+{
+	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
+
+	if (MutableDefault)
+	{
+		for (const FEventRestrictedConfigInfo& Config : MutableDefault->RestrictedConfigFiles)
+		{
+			const FEventSource* Source = FindTagSource(*Config.RestrictedConfigName);
+			if (Source)
+			{
+				Sources.Add(Source);
+			}
+		}
+	}
+}
+
+void UEventsManager::GetOwnersForTagSource(const FString& SourceName, TArray<FString>& OutOwners) const
+{
+	UEventsSettings* MutableDefault = GetMutableDefault<UEventsSettings>();
+
+	if (MutableDefault)
+	{
+		for (const FEventRestrictedConfigInfo& Config : MutableDefault->RestrictedConfigFiles)
+		{
+			if (Config.RestrictedConfigName.Equals(SourceName))
+			{
+				OutOwners = Config.Owners;
+				return;
+			}
+		}
+	}
+}
+
+void UEventsManager::EventContainerLoaded(FEventContainer& Container, FProperty* SerializingProperty) const
+{
+	RedirectTagsForContainer(Container, SerializingProperty);
+
+	if (OnEventLoadedDelegate.IsBound())
+	{
+		for (const FEventInfo& Tag : Container)
+		{
+			OnEventLoadedDelegate.Broadcast(Tag);
+		}
+	}
+}
 
 void UEventsManager::SingleEventLoaded(FEventInfo& Tag, FProperty* SerializingProperty) const
 {
@@ -637,6 +1164,30 @@ void UEventsManager::SingleEventLoaded(FEventInfo& Tag, FProperty* SerializingPr
 
 void UEventsManager::RedirectTagsForContainer(FEventContainer& Container, FProperty* SerializingProperty) const
 {
+	// Almost every container is current, check that without building the sets below
+	bool bNeedsRedirect = false;
+	if (TagRedirects.Num())
+	{
+		for (const FEventInfo& Tag : Container)
+		{
+			if (TagRedirects.Contains(Tag.GetTagName()))
+			{
+				bNeedsRedirect = true;
+				break;
+			}
+		}
+	}
+
+#if WITH_EDITOR
+	const bool bCheckInvalidTags = SerializingProperty && ShouldWarnOnInvalidTags();
+#else
+	const bool bCheckInvalidTags = false;
+#endif
+	if (!bNeedsRedirect && !bCheckInvalidTags)
+	{
+		return;
+	}
+
 	TSet<FName> NamesToRemove;
 	TSet<const FEventInfo*> TagsToAdd;
 
@@ -776,7 +1327,11 @@ void UEventsManager::InitializeManager()
 	}
 	}
 
-	SingletonManager->LoadEventTables(true);
+	// The cooked snapshot already holds the data table rows, the tables are only loaded without one
+	if (!SingletonManager->GetCookedSnapshot())
+	{
+		SingletonManager->LoadEventTables(true);
+	}
 	SingletonManager->ConstructEventTree();
 
 	// Bind to end of engine init to be done adding native tags
@@ -795,28 +1350,67 @@ void UEventsManager::PopulateTreeFromDataTable(class UDataTable* InTable)
 
 	FEventSource* FoundSource = FindOrAddTagSource(SourceName, EEventSourceType::DataTable);
 
-	for (const FEventTableRow* TagRow : TagTableRows)
+	AddTagTableRows(TArray<const FEventTableRow*>(TagTableRows), SourceName);
+}
+
+void UEventsManager::AddTagTableRow(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag)
+{
+	EnsureEventTree();
+	FEventTableRowSplit Split;
+	if (SplitTagTableRow(TagRow, SourceName, Split))
+	{
+		AddSplitTagTableRow(Split, SourceName, bIsRestrictedTag);
+	}
+}
+
+void UEventsManager::AddTagTableRows(TArrayView<const FEventTableRow* const> TagRows, FName SourceName, bool bIsRestrictedTag)
+{
+	EnsureEventTree();
+	TArray<FEventTableRowSplit> Splits;
+	Splits.SetNum(TagRows.Num());
+	TArray<uint8> ValidRows;
+	ValidRows.SetNumZeroed(TagRows.Num());
+
+	// String work and name creation don't touch the tree, so they are done in parallel into one buffer per source
+	ParallelFor(TagRows.Num(), [this, &TagRows, &Splits, &ValidRows, SourceName](int32 Index)
+	{
+		ValidRows[Index] = TagRows[Index] && SplitTagTableRow(*TagRows[Index], SourceName, Splits[Index]);
+	}, TagRows.Num() < EventParallelSplitThreshold);
+
+	// Inserting in the original row order keeps the tree identical to adding the rows one by one.
+	// A sorted insert per row moves every later sibling, so rows are appended and each sibling list sorted once
 	{
-		if (TagRow)
+		TGuardValue<bool> GuardDeferSort(bDeferChildSort, true);
+		for (int32 Index = 0; Index < Splits.Num(); ++Index)
 		{
-			AddTagTableRow(*TagRow, SourceName);
+			if (ValidRows[Index])
+			{
+				AddSplitTagTableRow(Splits[Index], SourceName, bIsRestrictedTag);
+			}
 		}
 	}
+	SortDeferredChildren();
 }
 
-void UEventsManager::AddTagTableRow(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag)
+void UEventsManager::SortDeferredChildren()
 {
-	TSharedPtr<FEventNode> CurNode = GameplayRootTag;
-	TArray<TSharedPtr<FEventNode>> AncestorNodes;
-	bool bAllowNonRestrictedChildren = true;
-
-	const FRestrictedEventTableRow* RestrictedTagRow = static_cast<const FRestrictedEventTableRow*>(&TagRow);
-	if (bIsRestrictedTag && RestrictedTagRow)
+	for (FEventNode* Parent : UnsortedParents)
 	{
-		bAllowNonRestrictedChildren = RestrictedTagRow->bAllowNonRestrictedChildren;
+		Algo::Sort(Parent->GetChildTagNodes(), [](const TSharedPtr<FEventNode>& A, const TSharedPtr<FEventNode>& B)
+		{
+			return A->GetSimpleTagName().LexicalLess(B->GetSimpleTagName());
+		});
 	}
+	UnsortedParents.Reset();
+}
+
+bool UEventsManager::SplitTagTableRow(const FEventTableRow& TagRow, FName SourceName, FEventTableRowSplit& OutSplit)
+{
+	OutSplit.Row = &TagRow;
+	OutSplit.SimpleNames.Reset();
+	OutSplit.CompleteNames.Reset();
 
-	// Split the tag text on the "." delimiter to establish tag depth and then insert each tag into the gameplay tag tree
+	// Split the tag text on the "." delimiter to establish tag depth
 	// We try to avoid as many FString->FName conversions as possible as they are slow
 	FName OriginalTagName = TagRow.Tag;
 	FString FullTagString = OriginalTagName.ToString();
@@ -834,7 +1428,7 @@ void UEventsManager::AddTagTableRow(const FEventTableRow& TagRow, FName SourceNa
 			{
 				// No way to fix it
 				UE_LOG(LogEvents, Error, TEXT("Invalid tag %s from source %s: %s!"), *FullTagString, *SourceName.ToString(), *ErrorText.ToString());
-				return;
+				return false;
 			}
 			else
 			{
@@ -853,15 +1447,12 @@ void UEventsManager::AddTagTableRow(const FEventTableRow& TagRow, FName SourceNa
 	FullTagString.Reset();
 
 	int32 NumSubTags = SubTags.Num();
-	bool bHasSeenConflict = false;
-
 	for (int32 SubTagIdx = 0; SubTagIdx < NumSubTags; ++SubTagIdx)
 	{
-		bool bIsExplicitTag = (SubTagIdx == (NumSubTags - 1));
 		FName ShortTagName = *SubTags[SubTagIdx];
 		FName FullTagName;
 
-		if (bIsExplicitTag)
+		if (SubTagIdx == (NumSubTags - 1))
 		{
 			// We already know the final name
 			FullTagName = OriginalTagName;
@@ -878,81 +1469,321 @@ void UEventsManager::AddTagTableRow(const FEventTableRow& TagRow, FName SourceNa
 			FullTagString += TEXT(".");
 			FullTagString += SubTags[SubTagIdx];
 
-			FullTagName = FName(*FullTagString);
+			FullTagName = FName(*FullTagString);
+		}
+
+		OutSplit.SimpleNames.Add(ShortTagName);
+		OutSplit.CompleteNames.Add(FullTagName);
+	}
+	return true;
+}
+
+void UEventsManager::AddSplitTagTableRow(const FEventTableRowSplit& Split, FName SourceName, bool bIsRestrictedTag)
+{
+	const FEventTableRow& TagRow = *Split.Row;
+	TSharedPtr<FEventNode> CurNode = GameplayRootTag;
+	TArray<TSharedPtr<FEventNode>> AncestorNodes;
+	bool bAllowNonRestrictedChildren = true;
+
+	const FRestrictedEventTableRow* RestrictedTagRow = static_cast<const FRestrictedEventTableRow*>(&TagRow);
+	if (bIsRestrictedTag && RestrictedTagRow)
+	{
+		bAllowNonRestrictedChildren = RestrictedTagRow->bAllowNonRestrictedChildren;
+	}
+
+	int32 NumSubTags = Split.SimpleNames.Num();
+	bool bHasSeenConflict = false;
+
+	for (int32 SubTagIdx = 0; SubTagIdx < NumSubTags; ++SubTagIdx)
+	{
+		bool bIsExplicitTag = (SubTagIdx == (NumSubTags - 1));
+		FName ShortTagName = Split.SimpleNames[SubTagIdx];
+		FName FullTagName = Split.CompleteNames[SubTagIdx];
+
+		TArray< TSharedPtr<FEventNode> >& ChildTags = CurNode.Get()->GetChildTagNodes();
+		CurNode = InsertTagIntoNodeArray(ShortTagName, FullTagName, CurNode, ChildTags, SourceName,TagRow, TagRow.DevComment, bIsExplicitTag, bIsRestrictedTag, bAllowNonRestrictedChildren);
+
+		// Tag conflicts only affect the editor so we don't look for them in the game
+#if WITH_EDITORONLY_DATA
+		if (bIsRestrictedTag)
+		{
+			CurNode->bAncestorHasConflict = bHasSeenConflict;
+
+			// If the sources don't match and the tag is explicit and we should've added the tag explicitly here, we have a conflict
+			if (CurNode->SourceName != SourceName && (CurNode->bIsExplicitTag && bIsExplicitTag))
+			{
+				// mark all ancestors as having a bad descendant
+				for (TSharedPtr<FEventNode> CurAncestorNode : AncestorNodes)
+				{
+					CurAncestorNode->bDescendantHasConflict = true;
+				}
+
+				// mark the current tag as having a conflict
+				CurNode->bNodeHasConflict = true;
+
+				// append source names
+				FString CombinedSources = CurNode->SourceName.ToString();
+				CombinedSources.Append(TEXT(" and "));
+				CombinedSources.Append(SourceName.ToString());
+				CurNode->SourceName = FName(*CombinedSources);
+
+				// mark all current descendants as having a bad ancestor
+				MarkChildrenOfNodeConflict(CurNode);
+			}
+
+			// mark any children we add later in this function as having a bad ancestor
+			if (CurNode->bNodeHasConflict)
+			{
+				bHasSeenConflict = true;
+			}
+
+			AncestorNodes.Add(CurNode);
+		}
+#endif
+	}
+}
+
+void UEventsManager::MarkChildrenOfNodeConflict(TSharedPtr<FEventNode> CurNode)
+{
+#if WITH_EDITORONLY_DATA
+	TArray< TSharedPtr<FEventNode> >& ChildTags = CurNode.Get()->GetChildTagNodes();
+	for (TSharedPtr<FEventNode> ChildNode : ChildTags)
+	{
+		ChildNode->bAncestorHasConflict = true;
+		MarkChildrenOfNodeConflict(ChildNode);
+	}
+#endif
+}
+
+UEventsManager::~UEventsManager()
+{
+	// The worker may still be reading the tree, its result is dropped rather than published while shutting down
+	if (AsyncTreeBuild.IsValid())
+	{
+		delete AsyncTreeBuild.Get();
+		AsyncTreeBuild = TFuture<FAsyncTreeBuild*>();
+	}
+	DestroyEventTree();
+
+	if (ReclaimTickHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(ReclaimTickHandle);
+	}
+	for (const FRetiredDictionary& Retired : RetiredDictionaries)
+	{
+		delete Retired.Dictionary;
+	}
+	delete PublishedDictionary.Exchange(nullptr);
+
+	if (SingletonManager == this)
+	{
+		SingletonManager = nullptr;
+	}
+}
+
+void UEventsManager::DestroyEventTree()
+{
+	FinishAsyncTreeBuild();
+	bEventTreeReleased = false;
+	if (GameplayRootTag.IsValid())
+	{
+		GameplayRootTag->ResetNode();
+		GameplayRootTag.Reset();
+		EventNodeMap.Reset();
+		UnsortedParents.Reset();
+	}
+	// The published dictionary stays allocated for readers that loaded it before the flag was set
+	bDictionaryDirty = true;
+	RestrictedEventSourceNames.Reset();
+}
+
+bool UEventsManager::AddEventIncremental(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag)
+{
+	EnsureEventTree();
+	if (!GameplayRootTag.IsValid() || TagRow.Tag.IsNone())
+	{
+		return false;
+	}
+
+	FEventTreeDelta Delta;
+	TArray<TSharedPtr<FEventNode>> AddedNodes;
+	AddRowNodes(TagRow, SourceName, bIsRestrictedTag, Delta, AddedNodes);
+
+	FinishIncrementalUpdate(AddedNodes, TArray<TSharedPtr<FEventNode>>(), Delta);
+	return ValidateTagCreation(TagRow.Tag);
+}
+
+bool UEventsManager::RemoveEventIncremental(FName TagName)
+{
+	EnsureEventTree();
+	TSharedPtr<FEventNode> Node = FindTagNode(TagName);
+	if (!Node.IsValid())
+	{
+		return false;
+	}
+
+	FEventTreeDelta Delta;
+	TArray<TSharedPtr<FEventNode>> RemovedNodes;
+	if (Node->GetChildTagNodes().Num() > 0)
+	{
+		// Still implied by its children
+#if WITH_EDITORONLY_DATA
+		Node->bIsExplicitTag = false;
+#endif
+	}
+	else
+	{
+		RemoveLeafNodes(Node, Delta, RemovedNodes);
+	}
+
+	FinishIncrementalUpdate(TArray<TSharedPtr<FEventNode>>(), RemovedNodes, Delta);
+	return true;
+}
+
+bool UEventsManager::RenameEventIncremental(FName OldTagName, FName NewTagName)
+{
+	EnsureEventTree();
+	TSharedPtr<FEventNode> OldNode = FindTagNode(OldTagName);
+	if (!OldNode.IsValid() || OldNode->GetChildTagNodes().Num() > 0 || OldTagName == NewTagName)
+	{
+		return false;
+	}
+
+	FEventTableRow TagRow(NewTagName, FString(), OldNode->Parameters);
+	TagRow.Throttle = OldNode->Throttle;
+	TagRow.Replication = OldNode->Replication;
+	FName SourceName = FEventSource::GetNativeName();
+#if WITH_EDITORONLY_DATA
+	TagRow.DevComment = OldNode->DevComment;
+	SourceName = OldNode->SourceName;
+#endif
+
+	FEventTreeDelta Delta;
+	TArray<TSharedPtr<FEventNode>> AddedNodes;
+	TArray<TSharedPtr<FEventNode>> RemovedNodes;
+
+	// The new tag may already exist, e.g. when the editor added it to its ini first
+	AddRowNodes(TagRow, SourceName, false, Delta, AddedNodes);
+	RemoveLeafNodes(OldNode, Delta, RemovedNodes);
+
+	// Keep the table flat, redirects that ended at the old name now end at the new one
+	const FEventInfo NewTag = RequestEvent(NewTagName, false);
+	for (TPair<FName, FEventInfo>& Redirect : TagRedirects)
+	{
+		if (Redirect.Value.GetTagName() == OldTagName)
+		{
+			Redirect.Value = NewTag;
+		}
+	}
+	TagRedirects.Add(OldTagName, NewTag);
+	Delta.Renamed.Emplace(OldTagName, NewTagName);
+
+	FinishIncrementalUpdate(AddedNodes, RemovedNodes, Delta);
+	return true;
+}
+
+void UEventsManager::AddRowNodes(const FEventTableRow& TagRow, FName SourceName, bool bIsRestrictedTag, FEventTreeDelta& Delta, TArray<TSharedPtr<FEventNode>>& OutAdded)
+{
+	FEventTableRowSplit Split;
+	if (!SplitTagTableRow(TagRow, SourceName, Split))
+	{
+		return;
+	}
+
+	// Levels that aren't in the map yet are the ones the insert creates
+	const int32 FirstNew = Split.CompleteNames.IndexOfByPredicate([this](FName CompleteName) { return !FindTagNode(CompleteName).IsValid(); });
+
+	AddSplitTagTableRow(Split, SourceName, bIsRestrictedTag);
+
+	for (int32 Level = FirstNew; Level != INDEX_NONE && Level < Split.CompleteNames.Num(); ++Level)
+	{
+		Delta.Added.Add(Split.CompleteNames[Level]);
+		OutAdded.Add(FindTagNode(Split.CompleteNames[Level]));
+	}
+}
+
+void UEventsManager::RemoveLeafNodes(TSharedPtr<FEventNode> Node, FEventTreeDelta& Delta, TArray<TSharedPtr<FEventNode>>& OutRemoved)
+{
+	while (Node.IsValid() && Node->GetChildTagNodes().Num() == 0)
+	{
+		TSharedPtr<FEventNode> ParentNode = Node->GetParentTagNode();
+		(ParentNode.IsValid() ? ParentNode : GameplayRootTag)->GetChildTagNodes().RemoveSingle(Node);
+
+		{
+#if WITH_EDITOR
+			FScopeLock Lock(&EventMapCritical);
+#endif
+			EventNodeMap.Remove(Node->GetCompleteTag());
+			bDictionaryDirty = true;
 		}
-			
-		TArray< TSharedPtr<FEventNode> >& ChildTags = CurNode.Get()->GetChildTagNodes();
-		int32 InsertionIdx = InsertTagIntoNodeArray(ShortTagName, FullTagName, CurNode, ChildTags, SourceName,TagRow, TagRow.DevComment, bIsExplicitTag, bIsRestrictedTag, bAllowNonRestrictedChildren);
 
-		CurNode = ChildTags[InsertionIdx];
+		Delta.Removed.Add(Node->GetCompleteTagName());
+		OutRemoved.Add(Node);
 
-		// Tag conflicts only affect the editor so we don't look for them in the game
-#if WITH_EDITORONLY_DATA
-		if (bIsRestrictedTag)
+		// Explicit parents stay, cooked builds don't know which parents are explicit and keep them all
+		Node = ParentNode;
+		if (Node.IsValid() && Node->IsExplicitTag())
 		{
-			CurNode->bAncestorHasConflict = bHasSeenConflict;
-
-			// If the sources don't match and the tag is explicit and we should've added the tag explicitly here, we have a conflict
-			if (CurNode->SourceName != SourceName && (CurNode->bIsExplicitTag && bIsExplicitTag))
-			{
-				// mark all ancestors as having a bad descendant
-				for (TSharedPtr<FEventNode> CurAncestorNode : AncestorNodes)
-				{
-					CurAncestorNode->bDescendantHasConflict = true;
-				}
+			break;
+		}
+	}
+}
 
-				// mark the current tag as having a conflict
-				CurNode->bNodeHasConflict = true;
+void UEventsManager::FinishIncrementalUpdate(const TArray<TSharedPtr<FEventNode>>& AddedNodes, const TArray<TSharedPtr<FEventNode>>& RemovedNodes, FEventTreeDelta& Delta)
+{
+	if (ShouldUseFastReplication() && (AddedNodes.Num() || RemovedNodes.Num()))
+	{
+		NetIndexFirstBitSegment = GetDefault<UEventsSettings>()->NetIndexFirstBitSegment;
 
-				// append source names
-				FString CombinedSources = CurNode->SourceName.ToString();
-				CombinedSources.Append(TEXT(" and "));
-				CombinedSources.Append(SourceName.ToString());
-				CurNode->SourceName = FName(*CombinedSources);
+		// Common tags lead and the rest is sorted by name, so removals and inserts only shift the indices after them
+		int32 FirstChanged = NetworkEventNodeIndex.Num();
+		for (const TSharedPtr<FEventNode>& Node : RemovedNodes)
+		{
+			CommonlyReplicatedTags.Remove(Node->GetCompleteTag());
 
-				// mark all current descendants as having a bad ancestor
-				MarkChildrenOfNodeConflict(CurNode);
+			int32 Index = MakeArrayView(NetworkEventNodeIndex.GetData(), NumCommonNetIndices).Find(Node);
+			if (Index != INDEX_NONE)
+			{
+				--NumCommonNetIndices;
+			}
+			else
+			{
+				Index = NumCommonNetIndices + Algo::LowerBound(GetSortedNetIndexRange(), Node, FCompareFEventNodeByTag());
 			}
 
-			// mark any children we add later in this function as having a bad ancestor
-			if (CurNode->bNodeHasConflict)
+			if (NetworkEventNodeIndex.IsValidIndex(Index) && NetworkEventNodeIndex[Index] == Node)
 			{
-				bHasSeenConflict = true;
+				NetworkEventNodeIndex.RemoveAt(Index, 1, false);
+				FirstChanged = FMath::Min(FirstChanged, Index);
 			}
+		}
 
-			AncestorNodes.Add(CurNode);
+		for (const TSharedPtr<FEventNode>& Node : AddedNodes)
+		{
+			const int32 Index = NumCommonNetIndices + Algo::LowerBound(GetSortedNetIndexRange(), Node, FCompareFEventNodeByTag());
+			NetworkEventNodeIndex.Insert(Node, Index);
+			FirstChanged = FMath::Min(FirstChanged, Index);
 		}
-#endif
+
+		AssignNetIndices(FirstChanged);
+		Delta.FirstChangedNetIndex = FirstChanged < NetworkEventNodeIndex.Num() ? FirstChanged : INDEX_NONE;
 	}
-}
 
-void UEventsManager::MarkChildrenOfNodeConflict(TSharedPtr<FEventNode> CurNode)
-{
-#if WITH_EDITORONLY_DATA
-	TArray< TSharedPtr<FEventNode> >& ChildTags = CurNode.Get()->GetChildTagNodes();
-	for (TSharedPtr<FEventNode> ChildNode : ChildTags)
+	// Removed nodes can outlive the tree in editor widgets, reset them so they don't keep their subtree alive
+	for (const TSharedPtr<FEventNode>& Node : RemovedNodes)
 	{
-		ChildNode->bAncestorHasConflict = true;
-		MarkChildrenOfNodeConflict(ChildNode);
+		Node->ResetNode();
 	}
-#endif
-}
 
-UEventsManager::~UEventsManager()
-{
-	DestroyEventTree();
-	SingletonManager = nullptr;
-}
+	RebuildDictionary();
 
-void UEventsManager::DestroyEventTree()
-{
-	if (GameplayRootTag.IsValid())
-	{
-		GameplayRootTag->ResetNode();
-		GameplayRootTag.Reset();
-		EventNodeMap.Reset();
-	}
-	RestrictedEventSourceNames.Reset();
+	IEventsModule::OnEventTreeDelta.Broadcast(Delta);
+	IEventsModule::OnEventTreeChanged.Broadcast();
+#if WITH_EDITOR
+	OnEditorRefreshEventTree.Broadcast();
+#endif
+
+	ReleaseEventTree();
 }
 
 bool UEventsManager::IsNativelyAddedTag(FEventInfo Tag) const
@@ -960,68 +1791,74 @@ bool UEventsManager::IsNativelyAddedTag(FEventInfo Tag) const
 	return NativeTagsToAdd.Contains(Tag.GetTagName());
 }
 
-int32 UEventsManager::InsertTagIntoNodeArray(FName Tag, FName FullTag, TSharedPtr<FEventNode> ParentNode, TArray< TSharedPtr<FEventNode> >& NodeArray, FName SourceName, const FEventTableRow& TagRow, const FString& DevComment, bool bIsExplicitTag, bool bIsRestrictedTag, bool bAllowNonRestrictedChildren)
+TSharedPtr<FEventNode> UEventsManager::InsertTagIntoNodeArray(FName Tag, FName FullTag, TSharedPtr<FEventNode> ParentNode, TArray< TSharedPtr<FEventNode> >& NodeArray, FName SourceName, const FEventTableRow& TagRow, const FString& DevComment, bool bIsExplicitTag, bool bIsRestrictedTag, bool bAllowNonRestrictedChildren)
 {
-	int32 FoundNodeIdx = INDEX_NONE;
-	int32 WhereToInsert = INDEX_NONE;
+	TSharedPtr<FEventNode> FoundNode;
+	int32 WhereToInsert = NodeArray.Num();
 
-	// See if the tag is already in the array
-	for (int32 CurIdx = 0; CurIdx < NodeArray.Num(); ++CurIdx)
+	if (bDeferChildSort)
+	{
+		// Siblings are sorted later, the complete name finds an existing node without them
+		FoundNode = EventNodeMap.FindRef(FEventInfo(FullTag));
+	}
+	else
 	{
-		FEventNode* CurrNode = NodeArray[CurIdx].Get();
-		if (CurrNode)
+		// Siblings are kept sorted, so a binary search gives both the existing node and the insert position
+		WhereToInsert = Algo::LowerBound(NodeArray, Tag, [](const TSharedPtr<FEventNode>& Node, FName Value)
 		{
-			FName SimpleTagName = CurrNode->GetSimpleTagName();
-			if (SimpleTagName == Tag)
-			{
-				FoundNodeIdx = CurIdx;
+			return Node->GetSimpleTagName().LexicalLess(Value);
+		});
+
+		if (NodeArray.IsValidIndex(WhereToInsert) && NodeArray[WhereToInsert]->GetSimpleTagName() == Tag)
+		{
+			FoundNode = NodeArray[WhereToInsert];
+		}
+	}
+
+	if (FoundNode.IsValid())
+	{
 #if WITH_EDITORONLY_DATA
-				// If we are explicitly adding this tag then overwrite the existing children restrictions with whatever is in the ini
-				// If we restrict children in the input data, make sure we restrict them in the existing node. This applies to explicit and implicitly defined nodes
-				if (bAllowNonRestrictedChildren == false || bIsExplicitTag)
+		FEventNode* CurrNode = FoundNode.Get();
+
+		// If we are explicitly adding this tag then overwrite the existing children restrictions with whatever is in the ini
+		// If we restrict children in the input data, make sure we restrict them in the existing node. This applies to explicit and implicitly defined nodes
+		if (bAllowNonRestrictedChildren == false || bIsExplicitTag)
 		{
-					// check if the tag is explicitly being created in more than one place.
-					if (CurrNode->bIsExplicitTag && bIsExplicitTag)
+			// check if the tag is explicitly being created in more than one place.
+			if (CurrNode->bIsExplicitTag && bIsExplicitTag)
 			{
-						// restricted tags always get added first
-						// 
-						// There are two possibilities if we're adding a restricted tag. 
-						// If the existing tag is non-restricted the restricted tag should take precedence. This may invalidate some child tags of the existing tag.
-						// If the existing tag is restricted we have a conflict. This is explicitly not allowed.
-						if (bIsRestrictedTag)
-						{
-							
-						}
-					}
-					CurrNode->bAllowNonRestrictedChildren = bAllowNonRestrictedChildren;
-					CurrNode->bIsExplicitTag = CurrNode->bIsExplicitTag || bIsExplicitTag;
+				// restricted tags always get added first
+				// 
+				// There are two possibilities if we're adding a restricted tag. 
+				// If the existing tag is non-restricted the restricted tag should take precedence. This may invalidate some child tags of the existing tag.
+				// If the existing tag is restricted we have a conflict. This is explicitly not allowed.
+				if (bIsRestrictedTag)
+				{
+					
 				}
-#endif				
-				break;
-			}
-			else if (Tag.LexicalLess(SimpleTagName) && WhereToInsert == INDEX_NONE)
-			{
-				// Insert new node before this
-				WhereToInsert = CurIdx;
 			}
+			CurrNode->bAllowNonRestrictedChildren = bAllowNonRestrictedChildren;
+			CurrNode->bIsExplicitTag = CurrNode->bIsExplicitTag || bIsExplicitTag;
 		}
+#endif
 	}
 
-	if (FoundNodeIdx == INDEX_NONE)
+	if (!FoundNode.IsValid())
 	{
-		if (WhereToInsert == INDEX_NONE)
-		{
-			// Insert at end
-			WhereToInsert = NodeArray.Num();
-		}
-
 		// Don't add the root node as parent
 		TSharedPtr<FEventNode> TagNode = MakeShareable(new FEventNode(Tag, FullTag, ParentNode != GameplayRootTag ? ParentNode : nullptr, bIsExplicitTag, bIsRestrictedTag, bAllowNonRestrictedChildren));
 
 		TagNode->Parameters = TagRow.Parameters;
+		TagNode->Throttle = TagRow.Throttle;
+		TagNode->Replication = TagRow.Replication;
 
-		// Add at the sorted location
-		FoundNodeIdx = NodeArray.Insert(TagNode, WhereToInsert);
+		// Add at the sorted location, or at the end until the deferred sort
+		NodeArray.Insert(TagNode, WhereToInsert);
+		if (bDeferChildSort)
+		{
+			UnsortedParents.Add(ParentNode.Get());
+		}
+		FoundNode = TagNode;
 
 		FEventInfo Event = TagNode->GetCompleteTag();
 
@@ -1035,6 +1872,7 @@ int32 UEventsManager::InsertTagIntoNodeArray(FName Tag, FName FullTag, TSharedPt
 			FScopeLock Lock(&EventMapCritical);
 #endif
 			EventNodeMap.Add(Event, TagNode);
+			bDictionaryDirty = true;
 		}
 	}
 
@@ -1042,28 +1880,39 @@ int32 UEventsManager::InsertTagIntoNodeArray(FName Tag, FName FullTag, TSharedPt
 	static FName NativeSourceName = FEventSource::GetNativeName();
 
 	// Set/update editor only data
-	if (NodeArray[FoundNodeIdx]->SourceName.IsNone() && !SourceName.IsNone())
+	if (FoundNode->SourceName.IsNone() && !SourceName.IsNone())
 	{
-		NodeArray[FoundNodeIdx]->SourceName = SourceName;
+		FoundNode->SourceName = SourceName;
 	}
 	else if (SourceName == NativeSourceName)
 	{
 		// Native overrides other types
-		NodeArray[FoundNodeIdx]->SourceName = SourceName;
+		FoundNode->SourceName = SourceName;
 	}
 
-	if (NodeArray[FoundNodeIdx]->DevComment.IsEmpty() && !DevComment.IsEmpty())
+	if (FoundNode->DevComment.IsEmpty() && !DevComment.IsEmpty())
 	{
-		NodeArray[FoundNodeIdx]->DevComment = DevComment;
+		FoundNode->DevComment = DevComment;
 	}
 #endif
 
-	return FoundNodeIdx;
+	return FoundNode;
 }
 
 void UEventsManager::PrintReplicationIndices()
 {
 
+	if (const FEventDictionaryPtr FlatDictionary = GetDictionary())
+	{
+		UE_LOG(LogEvents, Display, TEXT("::PrintReplicationIndices (TOTAL %d"), FlatDictionary->Num());
+
+		for (int32 Index = 0; Index < FlatDictionary->Num(); ++Index)
+		{
+			UE_LOG(LogEvents, Display, TEXT("Tag %s NetIndex: %d"), *FlatDictionary->GetTagName(Index).ToString(), FlatDictionary->GetNetIndex(Index));
+		}
+		return;
+	}
+
 	UE_LOG(LogEvents, Display, TEXT("::PrintReplicationIndices (TOTAL %d"), EventNodeMap.Num());
 
 	for (auto It : EventNodeMap)
@@ -1178,6 +2027,16 @@ void UEventsManager::PrintReplicationFrequencyReport()
 	UE_LOG(LogEvents, Warning, TEXT("================================="));
 }
 
+bool UEventsManager::WriteReplicationFrequencyReport(const FString& Filename) const
+{
+	FString Report = TEXT("Tag,Count\n");
+	for (const TPair<FEventInfo, int32>& It : ReplicationCountMap)
+	{
+		Report += FString::Printf(TEXT("%s,%d\n"), *It.Key.ToString(), It.Value);
+	}
+	return FFileHelper::SaveStringToFile(Report, *Filename);
+}
+
 void UEventsManager::NotifyTagReplicated(FEventInfo Tag, bool WasInContainer)
 {
 	ReplicationCountMap.FindOrAdd(Tag)++;
@@ -1597,15 +2456,23 @@ void UEventsManager::RequestEventContainer(const TArray<FString>& TagStrings, FE
 FEventInfo UEventsManager::RequestEvent(FName TagName, bool ErrorIfNotFound) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_UEventsManager_RequestEvent);
+	FEventInfo PossibleTag(TagName);
+
+	bool bFound = false;
+	if (const FEventDictionaryPtr FlatDictionary = GetDictionary())
+	{
+		bFound = FlatDictionary->Find(TagName) != INDEX_NONE;
+	}
+	else
+	{
 #if WITH_EDITOR
-	// This critical section is to handle and editor-only issue where tag requests come from another thread when async loading from a background thread in FEventContainer::Serialize.
-	// This function is not generically threadsafe.
-	FScopeLock Lock(&EventMapCritical);
+		// The map is only read while the tree is being built or edited, this handles requests coming from another thread when async loading from a background thread in FEventContainer::Serialize.
+		FScopeLock Lock(&EventMapCritical);
 #endif
+		bFound = EventNodeMap.Contains(PossibleTag);
+	}
 
-	FEventInfo PossibleTag(TagName);
-
-	if (EventNodeMap.Contains(PossibleTag))
+	if (bFound)
 	{
 		return PossibleTag;
 	}
@@ -1692,6 +2559,34 @@ bool UEventsManager::IsValidEventString(const FString& TagString, FText* OutErro
 
 FEventInfo UEventsManager::FindEventFromPartialString_Slow(FString PartialString) const
 {
+	FEventInfo PossibleTag(*PartialString);
+	FEventInfo FoundTag;
+
+	if (const FEventDictionaryPtr FlatDictionary = GetDictionary())
+	{
+		// Exact match first
+		if (FlatDictionary->Find(PossibleTag.GetTagName()) != INDEX_NONE)
+		{
+			return PossibleTag;
+		}
+
+		// Find shortest tag name that contains the match string
+		TArray<int32> Entries;
+		FlatDictionary->GetSearchIndex().Search(PartialString, EEventSearchMode::Substring, Entries);
+
+		int32 BestMatchLength = MAX_int32;
+		for (int32 Entry : Entries)
+		{
+			const int32 Length = FlatDictionary->GetTagName(Entry).GetStringLength();
+			if (Length < BestMatchLength)
+			{
+				FoundTag = FEventInfo(FlatDictionary->GetTagName(Entry));
+				BestMatchLength = Length;
+			}
+		}
+		return FoundTag;
+	}
+
 #if WITH_EDITOR
 	// This critical section is to handle and editor-only issue where tag requests come from another thread when async loading from a background thread in FEventContainer::Serialize.
 	// This function is not generically threadsafe.
@@ -1699,14 +2594,11 @@ FEventInfo UEventsManager::FindEventFromPartialString_Slow(FString PartialString
 #endif
 
 	// Exact match first
-	FEventInfo PossibleTag(*PartialString);
 	if (EventNodeMap.Contains(PossibleTag))
 	{
 		return PossibleTag;
 	}
 
-	// Find shortest tag name that contains the match string
-	FEventInfo FoundTag;
 	FEventContainer AllTags;
 	RequestAllEvents(AllTags, false);
 
@@ -1727,6 +2619,24 @@ FEventInfo UEventsManager::FindEventFromPartialString_Slow(FString PartialString
 	return FoundTag;
 }
 
+void UEventsManager::SearchEvents(const FString& Query, EEventSearchMode Mode, TArray<FEventInfo>& OutEvents, int32 MaxResults) const
+{
+	OutEvents.Reset();
+
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	if (!FlatDictionary)
+	{
+		return;
+	}
+
+	TArray<int32> Entries;
+	FlatDictionary->GetSearchIndex().Search(Query, Mode, Entries, MaxResults);
+	for (int32 Entry : Entries)
+	{
+		OutEvents.Add(FEventInfo(FlatDictionary->GetTagName(Entry)));
+	}
+}
+
 FEventInfo UEventsManager::AddNativeEvent(FName TagName, const FString& TagDevComment)
 {
 	if (TagName.IsNone())
@@ -1753,7 +2663,7 @@ FEventInfo UEventsManager::AddNativeEvent(FName TagName, const FString& TagDevCo
 }
 void UEventsManager::CallOrRegister_OnDoneAddingNativeTagsDelegate(FSimpleMulticastDelegate::FDelegate Delegate)
 {
-	if (bDoneAddingNativeTags)
+	if (bNativeTagTreeReady)
 	{
 		Delegate.Execute();
 	}
@@ -1789,27 +2699,40 @@ void UEventsManager::DoneAddingNativeTags()
 		OnLastChanceToAddNativeTags().Broadcast();
 		bDoneAddingNativeTags = true;
 
-		// We may add native tags that are needed for redirectors, so reconstruct the Event tree
-		DestroyEventTree();
-		ConstructEventTree();
-
-		OnDoneAddingNativeTagsDelegate().Broadcast();
+		// Native tags went into the tree as they were added, the final tree only has to be numbered and flattened again.
+		// Tables that haven't arrived yet start that themselves in FinishAsyncEventTableLoad, which then broadcasts
+		if (PendingEventTableLoads == 0)
+		{
+			StartAsyncTreeBuild();
+		}
 	}
 }
 
 FEventContainer UEventsManager::RequestEventParents(const FEventInfo& Event) const
 {
-	const FEventContainer* ParentTags = GetSingleTagContainer(Event);
+	const FEventParentChain Chain = GetSingleTagContainer(Event);
 
-	if (ParentTags)
+	FEventContainer ParentContainer;
+	for (const FEventInfo& Tag : Chain.GetTags())
 	{
-		return ParentTags->GetEventParents();
+		ParentContainer.Events.Add(Tag);
 	}
-	return FEventContainer();
+	return ParentContainer;
 }
 
 void UEventsManager::RequestAllEvents(FEventContainer& TagContainer, bool OnlyIncludeDictionaryTags) const
 {
+	// Only the tree knows which tags were declared rather than implied by their children
+	const FEventDictionaryPtr FlatDictionary = OnlyIncludeDictionaryTags ? nullptr : GetDictionary();
+	if (FlatDictionary)
+	{
+		for (int32 Index = 0; Index < FlatDictionary->Num(); ++Index)
+		{
+			TagContainer.AddTagFast(FEventInfo(FlatDictionary->GetTagName(Index)));
+		}
+		return;
+	}
+
 	TArray<TSharedPtr<FEventNode>> ValueArray;
 	EventNodeMap.GenerateValueArray(ValueArray);
 	for (const TSharedPtr<FEventNode>& TagNode : ValueArray)
@@ -1832,6 +2755,39 @@ FEventContainer UEventsManager::RequestEventChildren(const FEventInfo& Event) co
 {
 	FEventContainer TagContainer;
 	// Note this purposefully does not include the passed in Event in the container.
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	const FEventNodeView View = FlatDictionary ? FlatDictionary->GetView(FlatDictionary->Find(Event.GetTagName())) : FEventNodeView();
+	if (View.IsValid())
+	{
+		// The descendants are the pre-order range after the entry, already in the order AddChildrenTags produces
+		const int32 Index = View.GetIndex();
+		const int32 End = FlatDictionary->GetSubtreeEnd(Index);
+		if (End == Index + 1)
+		{
+			return TagContainer;
+		}
+
+		TagContainer.Events.Reserve(End - Index - 1);
+		for (FName ChildName : FlatDictionary->GetDescendantNames(Index))
+		{
+			TagContainer.Events.Add(FEventInfo(ChildName));
+		}
+
+		// The parents of the range are Event, its ancestors and every descendant with children of its own
+		for (int32 Parent = Index; Parent != INDEX_NONE; Parent = FlatDictionary->GetParent(Parent))
+		{
+			TagContainer.ParentTags.Add(FEventInfo(FlatDictionary->GetTagName(Parent)));
+		}
+		for (int32 Child = Index + 1; Child < End; ++Child)
+		{
+			if (FlatDictionary->GetSubtreeEnd(Child) > Child + 1)
+			{
+				TagContainer.ParentTags.Add(FEventInfo(FlatDictionary->GetTagName(Child)));
+			}
+		}
+		return TagContainer;
+	}
+
 	TSharedPtr<FEventNode> EventNode = FindTagNode(Event);
 	if (EventNode.IsValid())
 	{
@@ -1840,8 +2796,48 @@ FEventContainer UEventsManager::RequestEventChildren(const FEventInfo& Event) co
 	return TagContainer;
 }
 
+TArray<FName> UEventsManager::RequestEventDescendantNames(const FEventInfo& Event) const
+{
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	const int32 Index = FlatDictionary ? FlatDictionary->Find(Event.GetTagName()) : INDEX_NONE;
+	return Index != INDEX_NONE ? TArray<FName>(FlatDictionary->GetDescendantNames(Index)) : TArray<FName>();
+}
+
+FEventIndex UEventsManager::GetEventIndex(const FEventInfo& Event) const
+{
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	return FlatDictionary ? FlatDictionary->GetEventIndex(FlatDictionary->Find(Event)) : FEventIndex();
+}
+
+FEventInfo UEventsManager::GetEventFromIndex(FEventIndex EventIndex) const
+{
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	const int32 Index = FlatDictionary ? FlatDictionary->Find(EventIndex) : INDEX_NONE;
+	return Index != INDEX_NONE ? FEventInfo(FlatDictionary->GetTagName(Index)) : FEventInfo();
+}
+
+bool UEventsManager::EventIndexMatches(FEventIndex EventIndex, FEventIndex IndexToCheck) const
+{
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	if (!FlatDictionary)
+	{
+		return false;
+	}
+
+	const int32 Index = FlatDictionary->Find(EventIndex);
+	const int32 IndexOfCheck = FlatDictionary->Find(IndexToCheck);
+	return Index != INDEX_NONE && IndexOfCheck != INDEX_NONE && FlatDictionary->IsInSubtree(Index, IndexOfCheck);
+}
+
 FEventInfo UEventsManager::RequestEventDirectParent(const FEventInfo& Event) const
 {
+	FEventDictionaryPtr FlatDictionary;
+	const FEventNodeView View = FindTagView(Event, FlatDictionary);
+	if (View.IsValid())
+	{
+		return View.GetParent().IsValid() ? View.GetParent().GetCompleteTag() : FEventInfo();
+	}
+
 	TSharedPtr<FEventNode> EventNode = FindTagNode(Event);
 	if (EventNode.IsValid())
 	{
@@ -1889,6 +2885,18 @@ void UEventsManager::AddChildrenTags(FEventContainer& TagContainer, TSharedPtr<F
 
 void UEventsManager::SplitEventFName(const FEventInfo& Tag, TArray<FName>& OutNames) const
 {
+	FEventDictionaryPtr FlatDictionary;
+	FEventNodeView View = FindTagView(Tag, FlatDictionary);
+	if (View.IsValid())
+	{
+		OutNames.SetNum(View.GetDepth() + 1);
+		for (int32 Depth = View.GetDepth(); View.IsValid(); View = View.GetParent(), --Depth)
+		{
+			OutNames[Depth] = View.GetSimpleTagName();
+		}
+		return;
+	}
+
 	TSharedPtr<FEventNode> CurNode = FindTagNode(Tag);
 	while (CurNode.IsValid())
 	{
@@ -1899,6 +2907,29 @@ void UEventsManager::SplitEventFName(const FEventInfo& Tag, TArray<FName>& OutNa
 
 int32 UEventsManager::EventsMatchDepth(const FEventInfo& EventOne, const FEventInfo& EventTwo) const
 {
+	// Both views must come from the same dictionary for their indices to compare
+	FEventDictionaryPtr FlatDictionary;
+	FEventNodeView ViewOne = FindTagView(EventOne, FlatDictionary);
+	FEventNodeView ViewTwo = FlatDictionary ? FlatDictionary->GetView(FlatDictionary->Find(EventTwo.GetTagName())) : FEventNodeView();
+	if (ViewOne.IsValid() && ViewTwo.IsValid())
+	{
+		// Shared ancestors form a common prefix of both chains, climb to equal depth then to the common entry
+		while (ViewOne.GetDepth() > ViewTwo.GetDepth())
+		{
+			ViewOne = ViewOne.GetParent();
+		}
+		while (ViewTwo.GetDepth() > ViewOne.GetDepth())
+		{
+			ViewTwo = ViewTwo.GetParent();
+		}
+		while (ViewOne.IsValid() && ViewOne.GetIndex() != ViewTwo.GetIndex())
+		{
+			ViewOne = ViewOne.GetParent();
+			ViewTwo = ViewTwo.GetParent();
+		}
+		return ViewOne.IsValid() ? ViewOne.GetDepth() + 1 : 0;
+	}
+
 	TSet<FName> Tags1;
 	TSet<FName> Tags2;
 
@@ -1937,6 +2968,13 @@ bool UEventsManager::ValidateTagCreation(FName TagName) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_UEventsManager_ValidateTagCreation);
 
+	const FEventDictionaryPtr FlatDictionary = GetDictionary();
+	if (FlatDictionary && FlatDictionary->Find(TagName) != INDEX_NONE)
+	{
+		return true;
+	}
+
+	// Redirected names are only resolved by the tree
 	return FindTagNode(TagName).IsValid();
 }
 
@@ -1956,6 +2994,8 @@ FEventTableRow& FEventTableRow::operator=(FEventTableRow const& Other)
 	Tag = Other.Tag;
 	DevComment = Other.DevComment;
 	Parameters = Other.Parameters;
+	Throttle = Other.Throttle;
+	Replication = Other.Replication;
 	return *this;
 }
 
@@ -2023,23 +3063,64 @@ bool FRestrictedEventTableRow::operator!=(FRestrictedEventTableRow const& Other)
 	return true;
 }
 
-FEventNode::FEventNode(FName InTag, FName InFullTag, TSharedPtr<FEventNode> InParentNode, bool InIsExplicitTag, bool InIsRestrictedTag, bool InAllowNonRestrictedChildren)
-	: Tag(InTag)
-	, ParentNode(InParentNode)
-	, NetIndex(INVALID_TAGNETINDEX)
+FEventInfo FEventParentChain::GetRoot() const
 {
-	// Manually construct the tag container as we want to bypass the safety checks
-	CompleteTagWithParents.Events.Add(FEventInfo(InFullTag));
+	FEventInfo Root;
+	for (const FEventInfo& Tag : GetTags())
+	{
+		Root = Tag;
+	}
+	return Root;
+}
+
+bool FEventParentChain::HasTag(const FEventInfo& TagToCheck) const
+{
+	if (TagToCheck.IsValid())
+	{
+		for (const FEventInfo& Tag : GetTags())
+		{
+			if (Tag == TagToCheck)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
 
-	FEventNode* RawParentNode = ParentNode.Get();
-	if (RawParentNode && RawParentNode->GetSimpleTagName() != NAME_None)
+bool FEventParentChain::HasAny(const FEventContainer& ContainerToCheck) const
+{
+	for (const FEventInfo& OtherTag : ContainerToCheck)
 	{
-		// Our parent nodes are already constructed, and must have it's tag in Events[0]
-		const FEventContainer ParentContainer = RawParentNode->GetSingleTagContainer();
+		if (HasTag(OtherTag))
+		{
+			return true;
+		}
+	}
+	return false;
+}
 
-		CompleteTagWithParents.ParentTags.Add(ParentContainer.Events[0]);
-		CompleteTagWithParents.ParentTags.Append(ParentContainer.ParentTags);
+FEventContainer FEventParentChain::ToContainer() const
+{
+	// Manually construct the tag container as we want to bypass the safety checks
+	FEventContainer Container;
+	if (IsValid())
+	{
+		Container.Events.Add(GetTag());
+		for (const FEventInfo& ParentTag : GetParents())
+		{
+			Container.ParentTags.Add(ParentTag);
+		}
 	}
+	return Container;
+}
+
+FEventNode::FEventNode(FName InTag, FName InFullTag, TSharedPtr<FEventNode> InParentNode, bool InIsExplicitTag, bool InIsRestrictedTag, bool InAllowNonRestrictedChildren)
+	: Tag(InTag)
+	, CompleteTag(InFullTag)
+	, ParentNode(InParentNode)
+	, NetIndex(INVALID_TAGNETINDEX)
+{
 	
 #if WITH_EDITORONLY_DATA
 	bIsExplicitTag = InIsExplicitTag;
@@ -2055,7 +3136,7 @@ FEventNode::FEventNode(FName InTag, FName InFullTag, TSharedPtr<FEventNode> InPa
 void FEventNode::ResetNode()
 {
 	Tag = NAME_None;
-	CompleteTagWithParents.Reset();
+	CompleteTag = FEventInfo();
 	NetIndex = INVALID_TAGNETINDEX;
 
 	for (int32 ChildIdx = 0; ChildIdx < ChildTags.Num(); ++ChildIdx)
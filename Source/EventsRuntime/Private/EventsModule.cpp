@@ -4,8 +4,10 @@
 #include "Misc/ConfigCacheIni.h"
 #include "HAL/IConsoleManager.h"
 #include "UObject/Package.h"
+#include "Systems/EventChannel.h"
 
 FSimpleMulticastDelegate IEventsModule::OnEventTreeChanged;
+IEventsModule::FOnEventTreeDelta IEventsModule::OnEventTreeDelta;
 FSimpleMulticastDelegate IEventsModule::OnTagSettingsChanged;
 
 class FEventsModule : public IEventsModule
@@ -23,6 +25,23 @@ void FEventsModule::StartupModule()
 {
 	// This will force initialization
 	UEventsManager::Get();
+
+	// Channels resolve from whichever thread first listens or notifies, only the published dictionary is safe to read there
+	FEventChannel::ResolveEventParameters.BindLambda([](FName EventId, TArray<FEventParameterDesc>& OutParameters, FEventThrottle& OutThrottle)
+	{
+		const FEventDictionaryPtr Dictionary = UEventsManager::Get().GetDictionary();
+		const int32 Index = Dictionary ? Dictionary->Find(EventId) : INDEX_NONE;
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+
+		// Tags without parameters are usually plain ini tags, those are left to the first listener
+		const FEventEntryData& Data = Dictionary->GetEntryData(Index);
+		OutThrottle = Data.Throttle;
+		OutParameters = Data.Parameters;
+		return true;
+	});
 }
 
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -40,5 +59,6 @@ void FEventsModule::ShutdownModule()
 	}
 #endif
 
+	FEventChannel::ResolveEventParameters.Unbind();
 	UEventsManager::SingletonManager = nullptr;
 }
@@ -0,0 +1,144 @@
+// Copyright 2019 - 2021, butterfly, Event System Plugin, All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+#include "EventsManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace EventsManagerTests
+{
+	/** Complete names of the tree below Node in pre-order, children in their stored order */
+	void GetPreOrderNames(const FEventNode& Node, TArray<FName>& OutNames)
+	{
+		for (const TSharedPtr<FEventNode>& Child : Node.GetChildTagNodes())
+		{
+			OutNames.Add(Child->GetCompleteTagName());
+			GetPreOrderNames(*Child, OutNames);
+		}
+	}
+
+	TArray<const FEventTableRow*> GetRowPointers(const TArray<FEventTableRow>& Rows)
+	{
+		TArray<const FEventTableRow*> Pointers;
+		for (const FEventTableRow& Row : Rows)
+		{
+			Pointers.Add(&Row);
+		}
+		return Pointers;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEventsTreeBulkInsertTest, "Events.Manager.BulkInsert", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Adds many siblings in reverse order, the worst case for sorted inserts, once as a bulk source and once row by row.
+ * Both trees must be the same, the log reports the time each took.
+ */
+bool FEventsTreeBulkInsertTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumRows = 20000;
+
+	TArray<FEventTableRow> Rows;
+	Rows.Reserve(NumRows);
+	for (int32 Index = NumRows - 1; Index >= 0; --Index)
+	{
+		Rows.Add(FEventTableRow(*FString::Printf(TEXT("Bench.Group%d.Tag%05d"), Index % 8, Index)));
+	}
+
+	// Managers separate from the global one, so the test doesn't disturb the running game
+	UEventsManager* BulkManager = NewObject<UEventsManager>(GetTransientPackage());
+	BulkManager->GameplayRootTag = MakeShareable(new FEventNode());
+	const double BulkStart = FPlatformTime::Seconds();
+	BulkManager->AddTagTableRows(EventsManagerTests::GetRowPointers(Rows), FName(TEXT("Bench")));
+	const double BulkTime = FPlatformTime::Seconds() - BulkStart;
+
+	UEventsManager* RowManager = NewObject<UEventsManager>(GetTransientPackage());
+	RowManager->GameplayRootTag = MakeShareable(new FEventNode());
+	const double RowStart = FPlatformTime::Seconds();
+	for (const FEventTableRow& Row : Rows)
+	{
+		RowManager->AddTagTableRow(Row, FName(TEXT("Bench")));
+	}
+	const double RowTime = FPlatformTime::Seconds() - RowStart;
+
+	AddInfo(FString::Printf(TEXT("%d rows: bulk %.2f ms, row by row %.2f ms"), NumRows, BulkTime * 1000.0, RowTime * 1000.0));
+
+	TArray<FName> BulkNames;
+	TArray<FName> RowNames;
+	EventsManagerTests::GetPreOrderNames(*BulkManager->GameplayRootTag, BulkNames);
+	EventsManagerTests::GetPreOrderNames(*RowManager->GameplayRootTag, RowNames);
+
+	TestEqual(TEXT("Every row and its parents are in the tree"), BulkNames.Num(), NumRows + 8 + 1);
+	TestTrue(TEXT("Bulk and row by row inserts build the same tree"), BulkNames == RowNames);
+
+	BulkManager->DestroyEventTree();
+	RowManager->DestroyEventTree();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEventsNetIndexDeterminismTest, "Events.Manager.NetIndexDeterminism", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/** Net indices are what client and server agree on, they must not depend on the order sources and rows were added in */
+bool FEventsNetIndexDeterminismTest::RunTest(const FString& Parameters)
+{
+	TArray<FEventTableRow> FirstSource;
+	TArray<FEventTableRow> SecondSource;
+	for (int32 Index = 0; Index < 500; ++Index)
+	{
+		FirstSource.Add(FEventTableRow(*FString::Printf(TEXT("Net.First.Group%d.Tag%d"), Index % 7, Index)));
+		SecondSource.Add(FEventTableRow(*FString::Printf(TEXT("Net.Second.Group%d.Tag%d"), Index % 5, Index)));
+	}
+
+	// Shared parents come from both sources
+	FirstSource.Add(FEventTableRow(TEXT("Net.Shared.A")));
+	SecondSource.Add(FEventTableRow(TEXT("Net.Shared.B")));
+
+	TArray<FEventTableRow> ShuffledFirst = FirstSource;
+	TArray<FEventTableRow> ShuffledSecond = SecondSource;
+	FRandomStream Random(0x5EED);
+	for (TArray<FEventTableRow>* Rows : { &ShuffledFirst, &ShuffledSecond })
+	{
+		for (int32 Index = Rows->Num() - 1; Index > 0; --Index)
+		{
+			Rows->Swap(Index, Random.RandRange(0, Index));
+		}
+	}
+
+	UEventsManager* Ordered = NewObject<UEventsManager>(GetTransientPackage());
+	Ordered->GameplayRootTag = MakeShareable(new FEventNode());
+	Ordered->AddTagTableRows(EventsManagerTests::GetRowPointers(FirstSource), FName(TEXT("First")));
+	Ordered->AddTagTableRows(EventsManagerTests::GetRowPointers(SecondSource), FName(TEXT("Second")));
+	Ordered->ConstructNetIndex();
+
+	// Other source order, shuffled rows, and the second source row by row
+	UEventsManager* Shuffled = NewObject<UEventsManager>(GetTransientPackage());
+	Shuffled->GameplayRootTag = MakeShareable(new FEventNode());
+	for (const FEventTableRow& Row : ShuffledSecond)
+	{
+		Shuffled->AddTagTableRow(Row, FName(TEXT("Second")));
+	}
+	Shuffled->AddTagTableRows(EventsManagerTests::GetRowPointers(ShuffledFirst), FName(TEXT("First")));
+	Shuffled->ConstructNetIndex();
+
+	TestEqual(TEXT("Both trees have the same tags"), Shuffled->EventNodeMap.Num(), Ordered->EventNodeMap.Num());
+	TestEqual(TEXT("Both net index hashes match"), Shuffled->NetworkEventNodeIndexHash, Ordered->NetworkEventNodeIndexHash);
+
+	int32 NumMismatches = 0;
+	for (const TPair<FEventInfo, TSharedPtr<FEventNode>>& Pair : Ordered->EventNodeMap)
+	{
+		const TSharedPtr<FEventNode> Other = Shuffled->FindTagNode(Pair.Key);
+		if (!Other.IsValid() || Other->GetNetIndex() != Pair.Value->GetNetIndex())
+		{
+			++NumMismatches;
+		}
+	}
+	TestEqual(TEXT("Every tag has the same net index"), NumMismatches, 0);
+
+	Ordered->DestroyEventTree();
+	Shuffled->DestroyEventTree();
+	return true;
+}
+
+#endif
@@ -42,6 +42,10 @@ public:
 	/** Delegate for when assets are added to the tree */
 	static EVENTSRUNTIME_API FSimpleMulticastDelegate OnEventTreeChanged;
 
+	/** Delegate for incremental updates, called with the exact tags that changed before OnEventTreeChanged */
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnEventTreeDelta, const FEventTreeDelta&);
+	static EVENTSRUNTIME_API FOnEventTreeDelta OnEventTreeDelta;
+
 	/** Delegate that gets called after the settings have changed in the editor */
 	static EVENTSRUNTIME_API FSimpleMulticastDelegate OnTagSettingsChanged;
 };